@@ -0,0 +1,112 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file cvector.c
+ * @brief Implementation of the concurrent append-only vector
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "heap.h"
+#include "cvector.h"
+
+/**
+ * Segment `k` holds `CVECTOR_FIRST << k` members, index `i` lives in the segment of the
+ * highest bit of `i + CVECTOR_FIRST`, so all segments together cover any `size_t` index.
+ */
+#define CVECTOR_FIRST_BITS 6
+#define CVECTOR_FIRST (1UL << CVECTOR_FIRST_BITS)
+#define CVECTOR_SEGMENTS (64 - CVECTOR_FIRST_BITS)
+
+struct cvector_t
+{
+  size_t size;
+  void **segments[CVECTOR_SEGMENTS];
+};
+
+static inline size_t cvector_t_segment(const size_t index)
+{
+  return 63 - __builtin_clzll(index + CVECTOR_FIRST) - CVECTOR_FIRST_BITS;
+}
+
+static inline size_t cvector_t_offset(const size_t index, const size_t segment)
+{
+  return index + CVECTOR_FIRST - (CVECTOR_FIRST << segment);
+}
+
+/**
+ * @brief returns segment `k`, allocating it when no other thread did yet
+ */
+static void **cvector_t_reserve(cvector_t *v, const size_t k)
+{
+  void **segment = __atomic_load_n(&v->segments[k], __ATOMIC_ACQUIRE);
+
+  if (segment != NULL)
+    return segment;
+
+  size_t bytes = sizeof(void *) * (CVECTOR_FIRST << k);
+  void **allocated = malloc_realloc(bytes, NULL);
+  memset(allocated, 0, bytes);
+
+  // the losing threads free theirs and take the published one
+  if (!__atomic_compare_exchange_n(&v->segments[k], &segment, allocated, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+  {
+    heap_free(allocated);
+    return segment;
+  }
+
+  return allocated;
+}
+
+cvector_t *cvector_t_create(void)
+{
+  cvector_t *v = malloc_realloc(sizeof(cvector_t), NULL);
+  memset(v, 0, sizeof(cvector_t));
+
+  return v;
+}
+
+void cvector_t_destroy(cvector_t *v)
+{
+  if (v == NULL)
+    return;
+
+  for (size_t k = 0; k < CVECTOR_SEGMENTS; k++)
+    heap_free(v->segments[k]);
+
+  heap_free(v);
+}
+
+size_t cvector_t_push(cvector_t *v, void *item)
+{
+  size_t index = __atomic_fetch_add(&v->size, 1, __ATOMIC_RELAXED);
+  size_t k = cvector_t_segment(index);
+  void **segment = cvector_t_reserve(v, k);
+
+  __atomic_store_n(&segment[cvector_t_offset(index, k)], item, __ATOMIC_RELEASE);
+
+  return index;
+}
+
+void *cvector_t_get(const cvector_t *v, const size_t index)
+{
+  if (index >= __atomic_load_n(&v->size, __ATOMIC_RELAXED))
+    return NULL;
+
+  size_t k = cvector_t_segment(index);
+  void **segment = __atomic_load_n(&v->segments[k], __ATOMIC_ACQUIRE);
+
+  if (segment == NULL)
+    return NULL;
+
+  return __atomic_load_n(&segment[cvector_t_offset(index, k)], __ATOMIC_ACQUIRE);
+}
+
+size_t cvector_t_size(const cvector_t *v)
+{
+  return __atomic_load_n(&v->size, __ATOMIC_RELAXED);
+}
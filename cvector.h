@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file cvector.h
+ * @brief An append-only vector safe for concurrent producers and readers
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stddef.h>
+
+#ifndef CVECTOR_H
+#define CVECTOR_H
+
+/**
+ * @brief concurrent append-only vector container
+ *
+ * Members live in segments of doubling size that are allocated on demand and never moved,
+ * so growing does not invalidate what readers hold and needs no lock.
+ */
+typedef struct cvector_t cvector_t;
+
+/**
+ * @brief creates a new empty `cvector_t`
+ *
+ * @return `cvector_t*` pointer for created vector
+ */
+cvector_t *cvector_t_create(void);
+
+/**
+ * @brief destroys `cvector_t`, members are not freed
+ *
+ * @warning no other thread may use the vector anymore
+ *
+ * @param[in] vector
+ */
+void cvector_t_destroy(cvector_t *vector);
+
+/**
+ * @brief appends member to `cvector_t`, safe to call from any number of threads
+ *
+ * Reserves a position with a single atomic increment, then publishes the member there.
+ *
+ * @note `O(1)`, lock-free except for the allocation of a new segment
+ *
+ * @param[in] vector
+ * @param[in] item non-null member
+ * @return `size_t` index of the member
+ */
+size_t cvector_t_push(cvector_t *vector, void *item);
+
+/**
+ * @brief retrieves member at `index`, safe to call while other threads push
+ *
+ * @note `O(1)`
+ *
+ * @param[in] vector
+ * @param[in] index
+ * @return `void*` the member, `NULL` when `index` is not published yet
+ */
+void *cvector_t_get(const cvector_t *vector, const size_t index);
+
+/**
+ * @brief retrieves the number of positions reserved by `cvector_t_push`
+ *
+ * Positions reserved by pushes still in progress read as `NULL` until published.
+ *
+ * @param[in] vector
+ */
+size_t cvector_t_size(const cvector_t *vector);
+
+#endif // CVECTOR_H
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file deque.c
+ * @brief Implementation of the double-ended queue over a circular buffer
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "heap.h"
+#include "deque.h"
+
+#define DEQUE_MIN_CAPACITY 4
+
+struct deque_t
+{
+  void **items;
+  size_t head;
+  size_t size;
+  size_t capacity;
+};
+
+/**
+ * @brief buffer position of logical `index`, `capacity` is a power of two
+ */
+static inline size_t deque_t_slot(const deque_t *deque, const size_t index)
+{
+  return (deque->head + index) & (deque->capacity - 1);
+}
+
+/**
+ * @brief doubles the capacity, unwrapping the shorter of the two segments
+ */
+static void deque_t_grow(deque_t *deque)
+{
+  size_t capacity = deque->capacity;
+
+  deque->items = malloc_realloc(sizeof(void *) * capacity * 2, deque->items);
+  deque->capacity = capacity * 2;
+
+  // `size == capacity`, members wrap as `[head, capacity)` followed by `[0, head)`
+  if (deque->head == 0)
+    return;
+
+  if (deque->head < capacity - deque->head)
+  {
+    memcpy(&deque->items[capacity], deque->items, sizeof(void *) * deque->head);
+  }
+  else
+  {
+    memcpy(&deque->items[deque->head + capacity], &deque->items[deque->head], sizeof(void *) * (capacity - deque->head));
+    deque->head += capacity;
+  }
+}
+
+deque_t *deque_t_create(const size_t capacity)
+{
+  deque_t *deque = malloc_realloc(sizeof(deque_t), NULL);
+  size_t c = DEQUE_MIN_CAPACITY;
+
+  while (c < capacity)
+    c *= 2;
+
+  deque->items = malloc_realloc(sizeof(void *) * c, NULL);
+  deque->head = 0;
+  deque->size = 0;
+  deque->capacity = c;
+
+  return deque;
+}
+
+void deque_t_destroy(deque_t *deque)
+{
+  heap_free(deque->items);
+  heap_free(deque);
+}
+
+size_t deque_t_size(const deque_t *deque)
+{
+  return deque->size;
+}
+
+size_t deque_t_capacity(const deque_t *deque)
+{
+  return deque->capacity;
+}
+
+void deque_t_push_back(deque_t *deque, void *item)
+{
+  if (deque->size == deque->capacity)
+    deque_t_grow(deque);
+
+  deque->items[deque_t_slot(deque, deque->size)] = item;
+  deque->size++;
+}
+
+void deque_t_push_front(deque_t *deque, void *item)
+{
+  if (deque->size == deque->capacity)
+    deque_t_grow(deque);
+
+  deque->head = (deque->head - 1) & (deque->capacity - 1);
+  deque->items[deque->head] = item;
+  deque->size++;
+}
+
+void *deque_t_pop_back(deque_t *deque)
+{
+  if (deque->size == 0)
+    return NULL;
+
+  deque->size--;
+
+  return deque->items[deque_t_slot(deque, deque->size)];
+}
+
+void *deque_t_pop_front(deque_t *deque)
+{
+  if (deque->size == 0)
+    return NULL;
+
+  void *item = deque->items[deque->head];
+
+  deque->head = (deque->head + 1) & (deque->capacity - 1);
+  deque->size--;
+
+  return item;
+}
+
+void *deque_t_get(const deque_t *deque, const size_t index)
+{
+  if (index >= deque->size)
+    return NULL;
+
+  return deque->items[deque_t_slot(deque, index)];
+}
+
+void deque_t_set(deque_t *deque, const size_t index, void *item)
+{
+  if (index < deque->size)
+    deque->items[deque_t_slot(deque, index)] = item;
+}
+
+void deque_t_clean(deque_t *deque)
+{
+  deque->head = 0;
+  deque->size = 0;
+}
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file deque.h
+ * @brief A double-ended queue over a circular buffer
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stddef.h>
+
+#ifndef DEQUE_H
+#define DEQUE_H
+
+/**
+ * @brief double-ended queue container
+ *
+ * Members are pointers kept in a circular buffer whose capacity is a power of two,
+ * so both ends grow and shrink without shifting the others.
+ */
+typedef struct deque_t deque_t;
+
+/**
+ * @brief creates a new empty `deque_t`
+ *
+ * @param[in] capacity members to reserve room for, rounded up to a power of two
+ * @return `deque_t*` pointer for created deque
+ */
+deque_t *deque_t_create(const size_t capacity);
+
+/**
+ * @brief destroys `deque_t`, members are not freed
+ *
+ * @param[in] deque
+ */
+void deque_t_destroy(deque_t *deque);
+
+/**
+ * @brief retrieves the number of members of `deque_t`
+ *
+ * @param[in] deque
+ */
+size_t deque_t_size(const deque_t *deque);
+
+/**
+ * @brief retrieves the capacity of `deque_t`, always a power of two
+ *
+ * @param[in] deque
+ */
+size_t deque_t_capacity(const deque_t *deque);
+
+/**
+ * @brief inserts member after the last one of `deque_t`
+ *
+ * @note `O(1)` amortized, doubles the capacity when full
+ *
+ * @param[in] deque
+ * @param[in] item
+ */
+void deque_t_push_back(deque_t *deque, void *item);
+
+/**
+ * @brief inserts member before the first one of `deque_t`
+ *
+ * @note `O(1)` amortized, doubles the capacity when full
+ *
+ * @param[in] deque
+ * @param[in] item
+ */
+void deque_t_push_front(deque_t *deque, void *item);
+
+/**
+ * @brief removes and returns the last member of `deque_t`
+ *
+ * @note `O(1)`
+ *
+ * @param[in] deque
+ * @return `void*` the member, `NULL` when empty
+ */
+void *deque_t_pop_back(deque_t *deque);
+
+/**
+ * @brief removes and returns the first member of `deque_t`
+ *
+ * @note `O(1)`
+ *
+ * @param[in] deque
+ * @return `void*` the member, `NULL` when empty
+ */
+void *deque_t_pop_front(deque_t *deque);
+
+/**
+ * @brief retrieves member at logical position `index`, `0` being the front
+ *
+ * @note `O(1)`
+ *
+ * @param[in] deque
+ * @param[in] index
+ * @return `void*` the member, `NULL` when out of bounds
+ */
+void *deque_t_get(const deque_t *deque, const size_t index);
+
+/**
+ * @brief replaces member at logical position `index`, does nothing when out of bounds
+ *
+ * @note `O(1)`
+ *
+ * @param[in] deque
+ * @param[in] index
+ * @param[in] item
+ */
+void deque_t_set(deque_t *deque, const size_t index, void *item);
+
+/**
+ * @brief removes all members of `deque_t`, keeping its capacity
+ *
+ * @param[in] deque
+ */
+void deque_t_clean(deque_t *deque);
+
+#endif // DEQUE_H
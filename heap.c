@@ -8,9 +8,678 @@
  * @copyright Copyright (c) 2023 lightningspirit
  */
 
+#define _GNU_SOURCE
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include "heap.h"
+
+#ifdef HEAP_STATS
+#include <malloc.h>
+
+static heap_stats_t heap_counters;
+
+/**
+ * @brief counts one event of `counter` that took `taken` bytes and gave back `released` ones
+ *
+ * `size` is the requested size for the size classes, `0` for frees.
+ */
+static void heap_count(size_t *counter, const size_t size, const size_t released, const size_t taken)
+{
+  __atomic_add_fetch(counter, 1, __ATOMIC_RELAXED);
+
+  if (size > 0)
+  {
+    size_t class = size > 1 ? 64 - __builtin_clzll(size - 1) : 0;
+    __atomic_add_fetch(&heap_counters.classes[class < HEAP_STATS_CLASSES ? class : HEAP_STATS_CLASSES - 1], 1,
+                       __ATOMIC_RELAXED);
+  }
+
+  size_t live = __atomic_add_fetch(&heap_counters.live, taken - released, __ATOMIC_RELAXED);
+  size_t peak = __atomic_load_n(&heap_counters.peak, __ATOMIC_RELAXED);
+
+  while (live > peak && !__atomic_compare_exchange_n(&heap_counters.peak, &peak, live, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    ;
+}
+
+#define HEAP_COUNT(counter, size, released, taken) heap_count(&heap_counters.counter, size, released, taken)
+#else
+#define HEAP_COUNT(counter, size, released, taken)
+#endif
 
 void *malloc_realloc(size_t size, void *data)
 {
+#ifdef HEAP_STATS
+  size_t released = data != NULL ? malloc_usable_size(data) : 0;
+  void *moved = data == NULL ? malloc(size) : realloc(data, size);
+
+  if (moved == NULL)
+    return NULL;
+
+  if (data == NULL)
+    HEAP_COUNT(allocations, size, 0, malloc_usable_size(moved));
+  else
+    HEAP_COUNT(reallocations, size, released, malloc_usable_size(moved));
+
+  return moved;
+#else
   return data == NULL ? malloc(size) : realloc(data, size);
+#endif
+}
+
+void heap_free(void *data)
+{
+#ifdef HEAP_STATS
+  if (data != NULL)
+    HEAP_COUNT(frees, 0, malloc_usable_size(data), 0);
+#endif
+
+  free(data);
+}
+
+void heap_stats(heap_stats_t *stats)
+{
+#ifdef HEAP_STATS
+  stats->allocations = __atomic_load_n(&heap_counters.allocations, __ATOMIC_RELAXED);
+  stats->reallocations = __atomic_load_n(&heap_counters.reallocations, __ATOMIC_RELAXED);
+  stats->frees = __atomic_load_n(&heap_counters.frees, __ATOMIC_RELAXED);
+  stats->live = __atomic_load_n(&heap_counters.live, __ATOMIC_RELAXED);
+  stats->peak = __atomic_load_n(&heap_counters.peak, __ATOMIC_RELAXED);
+
+  for (size_t i = 0; i < HEAP_STATS_CLASSES; i++)
+    stats->classes[i] = __atomic_load_n(&heap_counters.classes[i], __ATOMIC_RELAXED);
+#else
+  memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+void heap_stats_dump(FILE *stream)
+{
+  heap_stats_t stats;
+  heap_stats(&stats);
+
+  fprintf(stream, "allocations: %zu\nreallocations: %zu\nfrees: %zu\nlive bytes: %zu\npeak bytes: %zu\n",
+          stats.allocations, stats.reallocations, stats.frees, stats.live, stats.peak);
+
+  for (size_t i = 0; i < HEAP_STATS_CLASSES; i++)
+    if (stats.classes[i] > 0)
+      fprintf(stream, "<= %zu bytes: %zu\n", (size_t)1 << i, stats.classes[i]);
+}
+
+static void *heap_allocator_alloc(size_t size, void *context)
+{
+  return malloc_realloc(size, NULL);
+}
+
+static void *heap_allocator_realloc(void *data, size_t old_size, size_t size, void *context)
+{
+  return malloc_realloc(size, data);
+}
+
+static void heap_allocator_free(void *data, size_t size, void *context)
+{
+  heap_free(data);
+}
+
+const allocator_t heap_allocator = {heap_allocator_alloc, heap_allocator_realloc, heap_allocator_free, NULL};
+
+/**
+ * Blocks are chained from the newest one, `last` is the latest allocation, the only one that can be
+ * resized or given back in place.
+ */
+typedef struct arena_block
+{
+  struct arena_block *next;
+  size_t size;
+  size_t used;
+  max_align_t data[];
+} arena_block;
+
+struct arena_t
+{
+  allocator_t allocator;
+  size_t block;
+  arena_block *blocks;
+  char *last;
+};
+
+static inline size_t arena_round(const size_t size)
+{
+  return (size + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+}
+
+static arena_block *arena_block_create(const size_t size, arena_block *next)
+{
+  arena_block *block = malloc_realloc(sizeof(arena_block) + size, NULL);
+
+  if (block == NULL)
+    return NULL;
+
+  block->next = next;
+  block->size = size;
+  block->used = 0;
+
+  return block;
+}
+
+static void *arena_allocator_alloc(size_t size, void *context)
+{
+  return arena_alloc(context, size);
+}
+
+static void *arena_allocator_realloc(void *data, size_t old_size, size_t size, void *context)
+{
+  arena_t *arena = context;
+
+  if (data == NULL)
+    return arena_alloc(arena, size);
+
+  // the latest allocation grows or shrinks where it is when the block has room
+  if (data == arena->last)
+  {
+    arena_block *block = arena->blocks;
+    size_t offset = arena->last - (char *)block->data;
+
+    if (offset + arena_round(size) <= block->size)
+    {
+      block->used = offset + arena_round(size);
+      return data;
+    }
+  }
+
+  void *moved = arena_alloc(arena, size);
+
+  if (moved != NULL)
+    memcpy(moved, data, old_size < size ? old_size : size);
+
+  return moved;
+}
+
+static void arena_allocator_free(void *data, size_t size, void *context)
+{
+  arena_t *arena = context;
+
+  if (data != NULL && data == arena->last)
+  {
+    arena->blocks->used = arena->last - (char *)arena->blocks->data;
+    arena->last = NULL;
+  }
+}
+
+arena_t *arena_create(size_t block)
+{
+  arena_t *arena = malloc_realloc(sizeof(arena_t), NULL);
+
+  if (arena == NULL)
+    return NULL;
+
+  arena->allocator.alloc = arena_allocator_alloc;
+  arena->allocator.realloc = arena_allocator_realloc;
+  arena->allocator.free = arena_allocator_free;
+  arena->allocator.context = arena;
+  arena->block = arena_round(block > 0 ? block : HEAP_ARENA_BLOCK);
+  arena->blocks = NULL;
+  arena->last = NULL;
+
+  return arena;
+}
+
+void *arena_alloc(arena_t *arena, size_t size)
+{
+  // the block header and rounding must not wrap around
+  if (size > SIZE_MAX - sizeof(arena_block) - _Alignof(max_align_t))
+    return NULL;
+
+  size_t rounded = arena_round(size > 0 ? size : 1);
+  arena_block *block = arena->blocks;
+
+  if (rounded > arena->block)
+  {
+    arena_block *large = arena_block_create(rounded, block != NULL ? block->next : NULL);
+
+    if (large == NULL)
+      return NULL;
+
+    // kept behind the current block, which goes on serving small allocations
+    if (block == NULL)
+      arena->blocks = large;
+    else
+      block->next = large;
+
+    large->used = rounded;
+    return large->data;
+  }
+
+  if (block == NULL || block->used + rounded > block->size)
+  {
+    if ((block = arena_block_create(arena->block, block)) == NULL)
+      return NULL;
+
+    arena->blocks = block;
+  }
+
+  arena->last = (char *)block->data + block->used;
+  block->used += rounded;
+
+  return arena->last;
+}
+
+void arena_reset(arena_t *arena)
+{
+  arena_block *block = arena->blocks;
+  arena_block *kept = NULL;
+
+  while (block != NULL)
+  {
+    arena_block *next = block->next;
+
+    // one regular block is kept, so the next round of allocations starts without a `malloc`
+    if (kept == NULL && block->size == arena->block)
+      kept = block;
+    else
+      heap_free(block);
+
+    block = next;
+  }
+
+  if (kept != NULL)
+  {
+    kept->next = NULL;
+    kept->used = 0;
+  }
+
+  arena->blocks = kept;
+  arena->last = NULL;
+}
+
+void arena_destroy(arena_t *arena)
+{
+  if (arena == NULL)
+    return;
+
+  while (arena->blocks != NULL)
+  {
+    arena_block *next = arena->blocks->next;
+    heap_free(arena->blocks);
+    arena->blocks = next;
+  }
+
+  heap_free(arena);
+}
+
+const allocator_t *arena_allocator(arena_t *arena)
+{
+  return &arena->allocator;
+}
+
+/**
+ * Live pools own one of `HEAP_POOL_CACHES` slots, the magazine of each thread at that slot is theirs.
+ * Ids are never reused, a magazine still holding the id of a destroyed pool is emptied before its slot
+ * serves another one. Pools created while all slots are taken always go to their free list under the lock.
+ * Threads give their magazines back to the pools still owning the slots when they exit.
+ */
+#define HEAP_POOL_CACHES 16
+
+typedef struct pool_slab
+{
+  struct pool_slab *next;
+  max_align_t data[];
+} pool_slab;
+
+struct pool_t
+{
+  allocator_t allocator;
+  size_t size;
+  size_t id;
+  size_t slot;
+  pthread_mutex_t lock;
+  void *free;
+  pool_slab *slabs;
+  char *carved;
+  char *end;
+};
+
+typedef struct
+{
+  size_t id;
+  size_t count;
+  void *items[HEAP_POOL_MAGAZINE];
+} pool_magazine;
+
+static size_t pool_ids = 0;
+static pool_t *pool_slots[HEAP_POOL_CACHES];
+static pthread_mutex_t pool_slots_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t pool_exit_key;
+static pthread_once_t pool_exit_once = PTHREAD_ONCE_INIT;
+static _Thread_local pool_magazine pool_magazines[HEAP_POOL_CACHES];
+
+/**
+ * @brief gives the magazines of an exiting thread back to their pools
+ */
+static void pool_exit(void *magazines)
+{
+  pool_magazine *magazine = magazines;
+
+  // pools are not destroyed while their slot is held
+  pthread_mutex_lock(&pool_slots_lock);
+
+  for (size_t slot = 0; slot < HEAP_POOL_CACHES; slot++, magazine++)
+  {
+    pool_t *pool = pool_slots[slot];
+
+    // objects of destroyed pools went with their slabs
+    if (pool == NULL || pool->id != magazine->id || magazine->count == 0)
+      continue;
+
+    pthread_mutex_lock(&pool->lock);
+
+    while (magazine->count > 0)
+    {
+      void *item = magazine->items[--magazine->count];
+      *(void **)item = pool->free;
+      pool->free = item;
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+  }
+
+  pthread_mutex_unlock(&pool_slots_lock);
+}
+
+static void pool_exit_create(void)
+{
+  pthread_key_create(&pool_exit_key, pool_exit);
+}
+
+/**
+ * @brief magazine of the calling thread for `pool`, `NULL` when it has no slot
+ */
+static inline pool_magazine *pool_magazine_of(const pool_t *pool)
+{
+  if (pool->slot == HEAP_POOL_CACHES)
+    return NULL;
+
+  pool_magazine *magazine = &pool_magazines[pool->slot];
+
+  // left by a destroyed pool, its objects went with its slabs
+  if (magazine->id != pool->id)
+  {
+    magazine->id = pool->id;
+    magazine->count = 0;
+
+    // the exit flush only runs for threads with a value set
+    pthread_setspecific(pool_exit_key, pool_magazines);
+  }
+
+  return magazine;
+}
+
+/**
+ * @brief takes an object off the free list or out of the current slab, `pool->lock` held
+ */
+static void *pool_take(pool_t *pool)
+{
+  void *data = pool->free;
+
+  if (data != NULL)
+  {
+    pool->free = *(void **)data;
+    return data;
+  }
+
+  if (pool->carved + pool->size > pool->end)
+  {
+    size_t bytes = HEAP_POOL_SLAB > sizeof(pool_slab) + pool->size ? HEAP_POOL_SLAB : sizeof(pool_slab) + pool->size;
+    pool_slab *slab = malloc_realloc(bytes, NULL);
+
+    if (slab == NULL)
+      return NULL;
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->carved = (char *)slab->data;
+    pool->end = (char *)slab + bytes;
+  }
+
+  data = pool->carved;
+  pool->carved += pool->size;
+
+  return data;
+}
+
+static void *pool_allocator_alloc(size_t size, void *context)
+{
+  pool_t *pool = context;
+
+  return size <= pool->size ? pool_alloc(pool) : malloc_realloc(size, NULL);
+}
+
+static void *pool_allocator_realloc(void *data, size_t old_size, size_t size, void *context)
+{
+  pool_t *pool = context;
+
+  if (data == NULL)
+    return pool_allocator_alloc(size, context);
+
+  if (old_size > pool->size && size > pool->size)
+    return malloc_realloc(size, data);
+
+  if (old_size <= pool->size && size <= pool->size)
+    return data;
+
+  void *moved = pool_allocator_alloc(size, context);
+
+  if (moved == NULL)
+    return NULL;
+
+  memcpy(moved, data, old_size < size ? old_size : size);
+
+  if (old_size <= pool->size)
+    pool_free(pool, data);
+  else
+    heap_free(data);
+
+  return moved;
+}
+
+static void pool_allocator_free(void *data, size_t size, void *context)
+{
+  pool_t *pool = context;
+
+  if (data == NULL)
+    return;
+
+  if (size <= pool->size)
+    pool_free(pool, data);
+  else
+    heap_free(data);
+}
+
+pool_t *pool_create(size_t size)
+{
+  // objects are rounded up to the alignment of `malloc`
+  if (size > SIZE_MAX - _Alignof(max_align_t))
+    return NULL;
+
+  pool_t *pool = malloc_realloc(sizeof(pool_t), NULL);
+
+  if (pool == NULL)
+    return NULL;
+
+  pool->allocator.alloc = pool_allocator_alloc;
+  pool->allocator.realloc = pool_allocator_realloc;
+  pool->allocator.free = pool_allocator_free;
+  pool->allocator.context = pool;
+  pool->size = (size + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1);
+  pool->size = pool->size > 0 ? pool->size : _Alignof(max_align_t);
+  pool->id = __atomic_add_fetch(&pool_ids, 1, __ATOMIC_RELAXED);
+  pthread_mutex_init(&pool->lock, NULL);
+  pool->free = NULL;
+  pool->slabs = NULL;
+  pool->carved = NULL;
+  pool->end = NULL;
+
+  pthread_once(&pool_exit_once, pool_exit_create);
+  pthread_mutex_lock(&pool_slots_lock);
+
+  for (pool->slot = 0; pool->slot < HEAP_POOL_CACHES; pool->slot++)
+  {
+    if (pool_slots[pool->slot] == NULL)
+    {
+      pool_slots[pool->slot] = pool;
+      break;
+    }
+  }
+
+  pthread_mutex_unlock(&pool_slots_lock);
+
+  return pool;
+}
+
+void *pool_alloc(pool_t *pool)
+{
+  pool_magazine *magazine = pool_magazine_of(pool);
+
+  if (magazine != NULL && magazine->count > 0)
+    return magazine->items[--magazine->count];
+
+  void *data = NULL;
+
+  pthread_mutex_lock(&pool->lock);
+
+  // refills half a magazine, so the next frees still have room
+  if (magazine != NULL)
+    while (magazine->count < HEAP_POOL_MAGAZINE / 2 && (data = pool_take(pool)) != NULL)
+      magazine->items[magazine->count++] = data;
+
+  data = pool_take(pool);
+
+  pthread_mutex_unlock(&pool->lock);
+
+  // out of memory, objects the refill got before are still there
+  if (data == NULL && magazine != NULL && magazine->count > 0)
+    data = magazine->items[--magazine->count];
+
+  return data;
+}
+
+void pool_free(pool_t *pool, void *data)
+{
+  pool_magazine *magazine = pool_magazine_of(pool);
+
+  if (magazine != NULL && magazine->count < HEAP_POOL_MAGAZINE)
+  {
+    magazine->items[magazine->count++] = data;
+    return;
+  }
+
+  pthread_mutex_lock(&pool->lock);
+
+  // returns half a magazine, so the next allocations still find objects
+  if (magazine != NULL)
+    while (magazine->count > HEAP_POOL_MAGAZINE / 2)
+    {
+      void *item = magazine->items[--magazine->count];
+      *(void **)item = pool->free;
+      pool->free = item;
+    }
+
+  *(void **)data = pool->free;
+  pool->free = data;
+
+  pthread_mutex_unlock(&pool->lock);
+}
+
+void pool_destroy(pool_t *pool)
+{
+  if (pool == NULL)
+    return;
+
+  if (pool->slot < HEAP_POOL_CACHES)
+  {
+    pthread_mutex_lock(&pool_slots_lock);
+    pool_slots[pool->slot] = NULL;
+    pthread_mutex_unlock(&pool_slots_lock);
+  }
+
+  while (pool->slabs != NULL)
+  {
+    pool_slab *next = pool->slabs->next;
+    heap_free(pool->slabs);
+    pool->slabs = next;
+  }
+
+  pthread_mutex_destroy(&pool->lock);
+  heap_free(pool);
+}
+
+const allocator_t *pool_allocator(pool_t *pool)
+{
+  return &pool->allocator;
+}
+
+void *malloc_aligned(size_t size, size_t alignment)
+{
+  void *data = NULL;
+
+  if (posix_memalign(&data, alignment, size) != 0)
+    return NULL;
+
+  HEAP_COUNT(allocations, size, 0, malloc_usable_size(data));
+
+  return data;
+}
+
+void *heap_map(size_t size)
+{
+  void *data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+  if (data == MAP_FAILED)
+    return NULL;
+
+#ifdef MADV_HUGEPAGE
+  // only advice, kernels without transparent huge pages keep regular ones
+  madvise(data, size, MADV_HUGEPAGE);
+#endif
+
+  HEAP_COUNT(allocations, size, 0, size);
+
+  return data;
+}
+
+void *heap_remap(void *data, size_t old_size, size_t size)
+{
+#ifdef MREMAP_MAYMOVE
+  void *moved = mremap(data, old_size, size, MREMAP_MAYMOVE);
+
+  if (moved == MAP_FAILED)
+    return NULL;
+
+#ifdef MADV_HUGEPAGE
+  if (size > old_size)
+    madvise(moved, size, MADV_HUGEPAGE);
+#endif
+
+  HEAP_COUNT(reallocations, size, old_size, size);
+
+  return moved;
+#else
+  void *moved = heap_map(size);
+
+  if (moved == NULL)
+    return NULL;
+
+  memcpy(moved, data, old_size < size ? old_size : size);
+  heap_unmap(data, old_size);
+
+  return moved;
+#endif
+}
+
+void heap_unmap(void *data, size_t size)
+{
+  HEAP_COUNT(frees, 0, size, 0);
+  munmap(data, size);
 }
@@ -8,11 +8,12 @@
  * @copyright Copyright (c) 2023 lightningspirit
  */
 
-#include <stddef.h>
-
 #ifndef HEAP_H
 #define HEAP_H
 
+#include <stddef.h>
+#include <stdio.h>
+
 /**
  * @brief allocates or reallocates memory safely
  *
@@ -24,4 +25,234 @@
  */
 void *malloc_realloc(size_t size, void *data);
 
+/**
+ * @brief releases memory of `malloc_realloc` or `malloc_aligned`, as `free`
+ *
+ * Containers release through it so `heap_stats` sees every block go.
+ *
+ * @param data
+ */
+void heap_free(void *data);
+
+/**
+ * @brief number of size classes of `heap_stats_t`
+ */
+#define HEAP_STATS_CLASSES 48
+
+/**
+ * @brief counters of the heap functions, kept when built with `-DHEAP_STATS` (`make stats`)
+ *
+ * Byte counts are the usable sizes reported by the C library, which round requests up;
+ * mapped memory counts its mapped size.
+ */
+typedef struct heap_stats_t
+{
+  size_t allocations;
+  size_t reallocations;
+  size_t frees;
+  size_t live;
+  size_t peak;
+  size_t classes[HEAP_STATS_CLASSES]; // allocations and reallocations of up to `1 << i` bytes
+} heap_stats_t;
+
+/**
+ * @brief reads the counters of all threads
+ *
+ * @param[out] stats all zeroes when built without `HEAP_STATS`
+ */
+void heap_stats(heap_stats_t *stats);
+
+/**
+ * @brief writes the counters to `stream` in a human readable form, skipping empty size classes
+ *
+ * @param stream
+ */
+void heap_stats_dump(FILE *stream);
+
+/**
+ * @brief memory source of containers, see the `_with_allocator` create functions
+ *
+ * Callbacks receive the size of the block as allocated, so allocators do not need to keep it.
+ * All of them get `context` as the last argument.
+ */
+typedef struct allocator_t
+{
+  void *(*alloc)(size_t size, void *context);
+  void *(*realloc)(void *data, size_t old_size, size_t size, void *context);
+  void (*free)(void *data, size_t size, void *context);
+  void *context;
+} allocator_t;
+
+/**
+ * @brief default allocator, `malloc_realloc` and `free`
+ */
+extern const allocator_t heap_allocator;
+
+/**
+ * @brief bump allocator releasing all of its memory at once, see `arena_reset`
+ *
+ * Memory is handed out by moving a pointer through large blocks, freeing a single allocation does nothing
+ * unless it is the last one. Containers of short-lived data built on `arena_allocator` need no destroy calls,
+ * resetting the arena takes one `free` per block instead of one per allocation.
+ *
+ * @warning not thread-safe
+ */
+typedef struct arena_t arena_t;
+
+/**
+ * @brief block size of arenas created with `0`
+ */
+#ifndef HEAP_ARENA_BLOCK
+#define HEAP_ARENA_BLOCK (64 * 1024)
+#endif
+
+/**
+ * @brief creates an empty `arena_t`, blocks are allocated on demand
+ *
+ * @param block bytes of each block, `0` for `HEAP_ARENA_BLOCK`; larger allocations get a block of their own
+ * @return arena_t*, `NULL` when out of memory
+ */
+arena_t *arena_create(size_t block);
+
+/**
+ * @brief allocates from the current block of `arena`
+ *
+ * @param arena
+ * @param size
+ * @return void* aligned as `malloc`, `NULL` when out of memory
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+/**
+ * @brief releases all allocations of `arena` at once, keeping one block for reuse
+ *
+ * @warning containers allocated from `arena` must not be used afterwards, there is no need to destroy them
+ *
+ * @param arena
+ */
+void arena_reset(arena_t *arena);
+
+/**
+ * @brief releases `arena` and all of its blocks
+ *
+ * @param arena
+ */
+void arena_destroy(arena_t *arena);
+
+/**
+ * @brief allocator handing out memory of `arena`, valid as long as `arena`
+ *
+ * Reallocating or freeing the last allocation resizes or gives it back in place.
+ *
+ * @param arena
+ * @return const allocator_t*
+ */
+const allocator_t *arena_allocator(arena_t *arena);
+
+/**
+ * @brief allocator of fixed-size objects carved from page-sized slabs
+ *
+ * Free objects are linked through their first word, so objects take no header. Each thread keeps
+ * a magazine of free objects per pool, allocating and freeing without locking until it runs empty or full,
+ * then it exchanges half a magazine with the pool under its lock. Slabs are only released by `pool_destroy`.
+ */
+typedef struct pool_t pool_t;
+
+/**
+ * @brief objects kept by each thread magazine
+ */
+#ifndef HEAP_POOL_MAGAZINE
+#define HEAP_POOL_MAGAZINE 64
+#endif
+
+/**
+ * @brief bytes of each pool slab
+ */
+#ifndef HEAP_POOL_SLAB
+#define HEAP_POOL_SLAB 4096
+#endif
+
+/**
+ * @brief creates an empty `pool_t` of objects of `size` bytes
+ *
+ * @param size rounded up to a multiple of `_Alignof(max_align_t)`, objects are aligned as `malloc`
+ * @return pool_t*, `NULL` when out of memory
+ */
+pool_t *pool_create(size_t size);
+
+/**
+ * @brief takes an object from the magazine of the calling thread, refilling it from `pool`
+ *
+ * @param pool
+ * @return void* aligned as `malloc`, `NULL` when out of memory
+ */
+void *pool_alloc(pool_t *pool);
+
+/**
+ * @brief gives `data` back to the magazine of the calling thread, any thread may free any object
+ *
+ * @param pool
+ * @param data object of `pool_alloc`
+ */
+void pool_free(pool_t *pool, void *data);
+
+/**
+ * @brief releases `pool` and all of its slabs
+ *
+ * @warning objects of `pool` must not be used afterwards, no other thread may use `pool` anymore
+ *
+ * @param pool
+ */
+void pool_destroy(pool_t *pool);
+
+/**
+ * @brief allocator serving blocks up to the object size of `pool` from it, larger ones from the heap
+ *
+ * @param pool
+ * @return const allocator_t*
+ */
+const allocator_t *pool_allocator(pool_t *pool);
+
+/**
+ * @brief buffers of at least this many bytes are worth backing with huge pages, see `heap_map`
+ */
+#ifndef HEAP_HUGE_THRESHOLD
+#define HEAP_HUGE_THRESHOLD (2 * 1024 * 1024)
+#endif
+
+/**
+ * @brief allocates memory aligned to `alignment`, released with `heap_free`
+ *
+ * @param size
+ * @param alignment power of two, multiple of `sizeof(void *)`
+ * @return void* `NULL` on failure
+ */
+void *malloc_aligned(size_t size, size_t alignment);
+
+/**
+ * @brief maps zeroed anonymous memory, advising the kernel to back it with huge pages
+ *
+ * @param size
+ * @return void* page aligned, `NULL` on failure
+ */
+void *heap_map(size_t size);
+
+/**
+ * @brief resizes memory of `heap_map`, moving the pages instead of copying them
+ *
+ * @param data
+ * @param old_size size given to `heap_map` or the last `heap_remap`
+ * @param size
+ * @return void* `NULL` on failure, `data` is left untouched then
+ */
+void *heap_remap(void *data, size_t old_size, size_t size);
+
+/**
+ * @brief releases memory of `heap_map`
+ *
+ * @param data
+ * @param size size given to `heap_map` or the last `heap_remap`
+ */
+void heap_unmap(void *data, size_t size);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file list.c
+ * @brief Implementation of the linked list handle
+ * @version 0.1
+ * @date 2024-08-17
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stdlib.h>
+#include "heap.h"
+#include "node.h"
+#include "list.h"
+
+struct list_t
+{
+  node_t *head;
+  node_t *tail;
+  size_t size;
+  const allocator_t *allocator;
+};
+
+list_t *list_t_create(void)
+{
+  return list_t_create_with_allocator(&heap_allocator);
+}
+
+list_t *list_t_create_with_allocator(const allocator_t *allocator)
+{
+  list_t *list = allocator->alloc(sizeof(list_t), allocator->context);
+
+  list->head = NULL;
+  list->tail = NULL;
+  list->size = 0;
+  list->allocator = allocator;
+
+  return list;
+}
+
+void list_t_destroy(list_t *list)
+{
+  if (list == NULL)
+    return;
+
+  node_t_destroy_with_allocator(list->head, list->allocator);
+  list->allocator->free(list, sizeof(list_t), list->allocator->context);
+}
+
+size_t list_t_size(const list_t *list)
+{
+  return list->size;
+}
+
+node_t *list_t_head(const list_t *list)
+{
+  return list->head;
+}
+
+node_t *list_t_tail(const list_t *list)
+{
+  return list->tail;
+}
+
+void list_t_push(list_t *list, void *item)
+{
+  node_t *tail = node_t_create_with_allocator(item, NULL, list->allocator);
+
+  if (list->tail == NULL)
+    list->head = tail;
+  else
+    node_t_link(list->tail, tail);
+
+  list->tail = tail;
+  list->size++;
+}
+
+void list_t_unshift(list_t *list, void *item)
+{
+  node_t_unshift_with_allocator(item, &list->head, list->allocator);
+
+  if (list->tail == NULL)
+    list->tail = list->head;
+
+  list->size++;
+}
+
+void *list_t_shift(list_t *list)
+{
+  if (list->head == NULL)
+    return NULL;
+
+  void *item = node_t_shift_with_allocator(&list->head, list->allocator);
+
+  if (list->head == NULL)
+    list->tail = NULL;
+
+  list->size--;
+
+  return item;
+}
+
+void list_t_concat(list_t *list, list_t *other)
+{
+  list_t_splice(list, list->tail, other);
+}
+
+void list_t_splice(list_t *list, node_t *node, list_t *other)
+{
+  if (list == other || other->head == NULL)
+    return;
+
+  if (node == NULL)
+  {
+    node_t_link(other->tail, list->head);
+    list->head = other->head;
+  }
+  else
+  {
+    node_t_link(other->tail, node_t_next(node));
+    node_t_link(node, other->head);
+  }
+
+  if (node == list->tail)
+    list->tail = other->tail;
+
+  list->size += other->size;
+
+  other->head = NULL;
+  other->tail = NULL;
+  other->size = 0;
+}
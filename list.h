@@ -0,0 +1,127 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file list.h
+ * @brief A linked list handle over `node_t` keeping its tail and size
+ * @version 0.1
+ * @date 2024-08-17
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stddef.h>
+#include "node.h"
+
+#ifndef LIST_H
+#define LIST_H
+
+/**
+ * @brief linked list container
+ *
+ * Keeps the first and last `node_t` of a list and how many there are, so appending, counting and joining
+ * lists take `O(1)` instead of walking the nodes as `node_t_push` and `node_t_size` do.
+ * Nodes can still be read and walked with `node_t_peek` and `node_t_next` from `list_t_head`.
+ */
+typedef struct list_t list_t;
+
+/**
+ * @brief creates a new empty `list_t`
+ *
+ * @return `list_t*` pointer for created list
+ */
+list_t *list_t_create(void);
+
+/**
+ * @brief creates a new empty `list_t` whose handle and nodes come from `allocator`
+ *
+ * @param[in] allocator must outlive the list, `node_t_allocator()` pools the nodes
+ * @return `list_t*` pointer for created list
+ */
+list_t *list_t_create_with_allocator(const allocator_t *allocator);
+
+/**
+ * @brief destroys `list_t` and its nodes, members are not freed
+ *
+ * @note `O(n)`
+ *
+ * @param[in] list
+ */
+void list_t_destroy(list_t *list);
+
+/**
+ * @brief retrieves the number of members of `list_t`
+ *
+ * @note `O(1)`
+ *
+ * @param[in] list
+ */
+size_t list_t_size(const list_t *list);
+
+/**
+ * @brief retrieves the first node, `NULL` when empty
+ *
+ * @param[in] list
+ */
+node_t *list_t_head(const list_t *list);
+
+/**
+ * @brief retrieves the last node, `NULL` when empty
+ *
+ * @param[in] list
+ */
+node_t *list_t_tail(const list_t *list);
+
+/**
+ * @brief inserts member after the last one of `list_t`
+ *
+ * @note `O(1)`
+ *
+ * @param[in] list
+ * @param[in] item
+ */
+void list_t_push(list_t *list, void *item);
+
+/**
+ * @brief inserts member before the first one of `list_t`
+ *
+ * @note `O(1)`
+ *
+ * @param[in] list
+ * @param[in] item
+ */
+void list_t_unshift(list_t *list, void *item);
+
+/**
+ * @brief removes and returns the first member of `list_t`
+ *
+ * @note `O(1)`
+ *
+ * @param[in] list
+ * @return `void*` the member, `NULL` when empty
+ */
+void *list_t_shift(list_t *list);
+
+/**
+ * @brief moves all nodes of `other` after the last one of `list`, leaving `other` empty
+ *
+ * @note `O(1)`
+ * @warning both lists must use the same allocator
+ *
+ * @param[in] list
+ * @param[in] other
+ */
+void list_t_concat(list_t *list, list_t *other);
+
+/**
+ * @brief moves all nodes of `other` right after `node` of `list`, leaving `other` empty
+ *
+ * @note `O(1)`
+ * @warning both lists must use the same allocator
+ *
+ * @param[in] list
+ * @param[in] node node of `list`, `NULL` moves them before the first one
+ * @param[in] other
+ */
+void list_t_splice(list_t *list, node_t *node, list_t *other);
+
+#endif // LIST_H
@@ -13,22 +13,58 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <unistd.h>
 #include "matrix.h"
 #include "heap.h"
+#include "vector_io.h"
 
 struct matrix_t
 {
   size_t cols;
   size_t rows;
   vector_t *vector;
+  const allocator_t *allocator;
 };
 
 matrix_t *matrix_t_create(const size_t rows, const size_t cols)
 {
-  matrix_t *matrix = (matrix_t *)malloc_realloc(sizeof(matrix_t), NULL);
+  return matrix_t_create_with_allocator(rows, cols, &heap_allocator);
+}
+
+matrix_t *matrix_t_create_with_allocator(const size_t rows, const size_t cols, const allocator_t *allocator)
+{
+  matrix_t *matrix = (matrix_t *)allocator->alloc(sizeof(matrix_t), allocator->context);
   matrix->cols = cols;
   matrix->rows = rows;
-  matrix->vector = vector_t_create(rows * cols);
+  matrix->vector = vector_t_create_with_allocator(rows * cols, allocator);
+  matrix->allocator = allocator;
+
+  return matrix;
+}
+
+matrix_t *matrix_t_create_sized(const size_t width, const size_t rows, const size_t cols)
+{
+  return matrix_t_create_sized_with_allocator(width, rows, cols, &heap_allocator);
+}
+
+matrix_t *matrix_t_create_sized_with_allocator(const size_t width, const size_t rows, const size_t cols,
+                                               const allocator_t *allocator)
+{
+  matrix_t *matrix = (matrix_t *)allocator->alloc(sizeof(matrix_t), allocator->context);
+
+  if (matrix == NULL)
+    return NULL;
+
+  matrix->cols = cols;
+  matrix->rows = rows;
+  matrix->vector = vector_t_create_sized_with_allocator(width, rows * cols, allocator);
+  matrix->allocator = allocator;
+
+  if (matrix->vector == NULL)
+  {
+    allocator->free(matrix, sizeof(matrix_t), allocator->context);
+    return NULL;
+  }
 
   return matrix;
 }
@@ -44,7 +80,7 @@ void matrix_t_resize(matrix_t *matrix, const size_t rows, const size_t cols)
 void matrix_t_destroy(matrix_t *matrix)
 {
   vector_t_destroy(matrix->vector);
-  free(matrix);
+  matrix->allocator->free(matrix, sizeof(matrix_t), matrix->allocator->context);
 }
 
 size_t matrix_t_cols(matrix_t *matrix)
@@ -79,8 +115,11 @@ void *matrix_t_get(matrix_t *matrix, const size_t row, const size_t col)
 
 matrix_t *matrix_t_copy(matrix_t *matrix)
 {
-  matrix_t *copied = matrix_t_create(matrix->rows, matrix->cols);
+  matrix_t *copied = (matrix_t *)matrix->allocator->alloc(sizeof(matrix_t), matrix->allocator->context);
+  copied->cols = matrix->cols;
+  copied->rows = matrix->rows;
   copied->vector = vector_t_copy(matrix->vector);
+  copied->allocator = matrix->allocator;
   return copied;
 }
 
@@ -103,6 +142,53 @@ void matrix_t_remove_row(matrix_t *matrix, const size_t row)
   vector_t_remove(matrix->vector, start, end);
 }
 
+void matrix_t_align(matrix_t *matrix, const size_t alignment)
+{
+  vector_t_align(matrix->vector, alignment);
+}
+
+void matrix_t_huge_pages(matrix_t *matrix, const int enabled)
+{
+  vector_t_huge_pages(matrix->vector, enabled);
+}
+
+int matrix_t_save(const matrix_t *matrix, const char *path)
+{
+  size_t width = vector_t_element_size(matrix->vector);
+
+  if (width == 0)
+    return -1;
+
+  vector_io_header header = {.width = width, .count = matrix->rows * matrix->cols, .rows = matrix->rows, .cols = matrix->cols};
+
+  // sized members are contiguous, starting at the first one, removals leave zero cells past the end
+  return vector_io_save(path, &header, vector_t_get(matrix->vector, 0), vector_t_size(matrix->vector));
+}
+
+matrix_t *matrix_t_load(const char *path)
+{
+  vector_io_header header;
+  int fd = vector_io_open(path, &header);
+
+  if (fd < 0)
+    return NULL;
+
+  // vector snapshots load as a single row
+  size_t rows = header.rows > 0 ? header.rows : 1;
+  size_t cols = header.rows > 0 ? header.cols : header.count;
+  matrix_t *matrix = matrix_t_create_sized(header.width, rows, cols);
+
+  if (matrix != NULL && header.count > 0 && vector_io_read(fd, vector_t_get(matrix->vector, 0), header.count * header.width) != 0)
+  {
+    matrix_t_destroy(matrix);
+    matrix = NULL;
+  }
+
+  close(fd);
+
+  return matrix;
+}
+
 size_t matrix_t_idx(matrix_t *matrix, const size_t row, const size_t col)
 {
   return row * matrix->cols + col;
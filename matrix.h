@@ -33,6 +33,42 @@ typedef struct matrix_t matrix_t;
  */
 matrix_t *matrix_t_create(const size_t rows, const size_t cols);
 
+/**
+ * @brief Creates a new matrix storing cells by value
+ *
+ * Cells of `width` bytes are kept in a sized vector, see `vector_t_create_sized`.
+ *
+ * @param width Size of each cell in bytes.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @return matrix_t* Pointer to the created matrix, cells are zeroed, `NULL` when they can not be allocated
+ */
+matrix_t *matrix_t_create_sized(const size_t width, const size_t rows, const size_t cols);
+
+/**
+ * @brief Creates a new matrix whose memory comes from `allocator`
+ *
+ * The matrix and its underlying vector are taken from and given back to `allocator`, see `vector_t_create_with_allocator`.
+ *
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param allocator Must outlive the matrix.
+ * @return matrix_t* Pointer to the created matrix
+ */
+matrix_t *matrix_t_create_with_allocator(const size_t rows, const size_t cols, const allocator_t *allocator);
+
+/**
+ * @brief Creates a new matrix storing cells by value whose memory comes from `allocator`
+ *
+ * @param width Size of each cell in bytes.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @param allocator Must outlive the matrix.
+ * @return matrix_t* Pointer to the created matrix, cells are zeroed, `NULL` when they can not be allocated
+ */
+matrix_t *matrix_t_create_sized_with_allocator(const size_t width, const size_t rows, const size_t cols,
+                                               const allocator_t *allocator);
+
 /**
  * @brief Resizes a matrix to the specified number of columns and rows.
  *
@@ -91,6 +127,8 @@ void *matrix_t_get(matrix_t *matrix, const size_t row, const size_t col);
 /**
  * @brief Copies the matrix
  *
+ * Cells are shared with `matrix` until either one is modified, see `vector_t_copy`.
+ *
  * @param matrix Pointer to the matrix
  * @return matrix_t New matrix
  */
@@ -113,6 +151,41 @@ void matrix_t_remove(matrix_t *matrix, const size_t row, const size_t col);
  */
 void matrix_t_remove_row(matrix_t *matrix, const size_t row);
 
+/**
+ * @brief Aligns the cells of the matrix, see `vector_t_align`
+ *
+ * @param matrix Pointer to the matrix
+ * @param alignment Power of two, `0` for the default of `malloc`
+ */
+void matrix_t_align(matrix_t *matrix, const size_t alignment);
+
+/**
+ * @brief Enables or disables huge page backed cells, see `vector_t_huge_pages`
+ *
+ * @param matrix Pointer to the matrix
+ * @param enabled
+ */
+void matrix_t_huge_pages(matrix_t *matrix, const int enabled);
+
+/**
+ * @brief Writes the cells of a sized matrix to a binary snapshot, see `vector_t_save`
+ *
+ * @param matrix Pointer to the matrix
+ * @param path Path of the snapshot, replaced once completely written
+ * @return int `0` on success, `-1` on failure or for matrices of pointers
+ */
+int matrix_t_save(const matrix_t *matrix, const char *path);
+
+/**
+ * @brief Creates a sized matrix out of a snapshot of `matrix_t_save`
+ *
+ * Cells are read at once into the matrix buffer. Snapshots of `vector_t_save` load as a single row.
+ *
+ * @param path Path of the snapshot
+ * @return matrix_t* Pointer to the loaded matrix, `NULL` when the file is not a valid snapshot
+ */
+matrix_t *matrix_t_load(const char *path);
+
 /**
  * @brief Retrieves the internal index for given cell
  *
@@ -11,6 +11,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <pthread.h>
 #include "heap.h"
 #include "node.h"
 
@@ -20,9 +21,37 @@ struct node_t
   struct node_t *next;
 };
 
+#ifdef NODE_STATS
+static node_t_stats_t node_t_counters;
+
+#define NODE_T_COUNT(counter, n) __atomic_add_fetch(&node_t_counters.counter, (n), __ATOMIC_RELAXED)
+#else
+#define NODE_T_COUNT(counter, n)
+#endif
+
+static pool_t *node_t_pool = NULL;
+static pthread_once_t node_t_pool_once = PTHREAD_ONCE_INIT;
+
+static void node_t_pool_create(void)
+{
+  node_t_pool = pool_create(sizeof(node_t));
+}
+
+const allocator_t *node_t_allocator(void)
+{
+  pthread_once(&node_t_pool_once, node_t_pool_create);
+
+  return pool_allocator(node_t_pool);
+}
+
 node_t *node_t_create(void *value, node_t *next)
 {
-  node_t *n = malloc_realloc(sizeof(*n), NULL);
+  return node_t_create_with_allocator(value, next, &heap_allocator);
+}
+
+node_t *node_t_create_with_allocator(void *value, node_t *next, const allocator_t *allocator)
+{
+  node_t *n = allocator->alloc(sizeof(*n), allocator->context);
 
   n->value = value;
   n->next = next;
@@ -31,13 +60,18 @@ node_t *node_t_create(void *value, node_t *next)
 }
 
 void node_t_destroy(node_t *head)
+{
+  node_t_destroy_with_allocator(head, &heap_allocator);
+}
+
+void node_t_destroy_with_allocator(node_t *head, const allocator_t *allocator)
 {
   node_t *next;
 
   while (head != NULL)
   {
     next = head->next;
-    free(head);
+    allocator->free(head, sizeof(*head), allocator->context);
     head = next;
   }
 }
@@ -53,6 +87,8 @@ size_t node_t_size(node_t *head)
     size++;
   }
 
+  NODE_T_COUNT(walked, size);
+
   return size;
 }
 
@@ -66,12 +102,30 @@ node_t *node_t_next(node_t *n)
   return n != NULL ? n->next : NULL;
 }
 
+node_t *node_t_link(node_t *n, node_t *next)
+{
+  node_t *rest = n->next;
+  n->next = next;
+
+  return rest;
+}
+
 void node_t_unshift(void *value, node_t **head)
 {
-  *head = node_t_create(value, *head);
+  node_t_unshift_with_allocator(value, head, &heap_allocator);
+}
+
+void node_t_unshift_with_allocator(void *value, node_t **head, const allocator_t *allocator)
+{
+  *head = node_t_create_with_allocator(value, *head, allocator);
 }
 
 void *node_t_shift(node_t **head)
+{
+  return node_t_shift_with_allocator(head, &heap_allocator);
+}
+
+void *node_t_shift_with_allocator(node_t **head, const allocator_t *allocator)
 {
   if (*head == NULL)
     return NULL;
@@ -79,13 +133,18 @@ void *node_t_shift(node_t **head)
   node_t *shift = *head;
   void *v = shift->value;
   *head = shift->next;
-  free(shift);
+  allocator->free(shift, sizeof(*shift), allocator->context);
   return v;
 }
 
 node_t *node_t_push(void *value, node_t **head)
 {
-  node_t *tail = node_t_create(value, NULL);
+  return node_t_push_with_allocator(value, head, &heap_allocator);
+}
+
+node_t *node_t_push_with_allocator(void *value, node_t **head, const allocator_t *allocator)
+{
+  node_t *tail = node_t_create_with_allocator(value, NULL, allocator);
 
   if (*head == NULL)
   {
@@ -94,11 +153,26 @@ node_t *node_t_push(void *value, node_t **head)
   else
   {
     node_t *cursor = *head;
+    size_t walked = 1;
 
     while (cursor->next != NULL)
+    {
       cursor = cursor->next;
+      walked++;
+    }
+
     cursor->next = tail;
+    NODE_T_COUNT(walked, walked);
   }
 
   return tail;
 }
+
+void node_t_stats(node_t_stats_t *stats)
+{
+#ifdef NODE_STATS
+  stats->walked = __atomic_load_n(&node_t_counters.walked, __ATOMIC_RELAXED);
+#else
+  stats->walked = 0;
+#endif
+}
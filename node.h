@@ -14,11 +14,21 @@
 #ifndef NODE_H
 #define NODE_H
 
+#include "heap.h"
+
 /**
  * @brief Node structure
  */
 typedef struct node_t node_t;
 
+/**
+ * @brief Counters of the `node_t` walks over all lists, kept when built with `-DNODE_STATS` (`make stats`)
+ */
+typedef struct node_t_stats_t
+{
+  size_t walked; // nodes visited by `node_t_size` and `node_t_push`
+} node_t_stats_t;
+
 /**
  * @brief Returns a new `node_t` with given value, beginning a new list
  *
@@ -66,6 +76,14 @@ void *node_t_peek(node_t *node);
  */
 node_t *node_t_next(node_t *node);
 
+/**
+ * @brief Places `next` as the next linked `node_t` of `node`, replacing the previous one.
+ *
+ * @note `O(1)`
+ * @return `node_t` the previous next node, now unlinked from `node`
+ */
+node_t *node_t_link(node_t *node, node_t *next);
+
 /**
  * @brief Creates a new `node_t` and places `node` as the next linked `node_t`.
  *
@@ -95,4 +113,51 @@ void *node_t_shift(node_t **head);
  */
 node_t *node_t_push(void *value, node_t **tail);
 
+/**
+ * @brief Reads the walk counters of all lists and threads
+ *
+ * @param[out] stats all zeroes when built without `NODE_STATS`
+ */
+void node_t_stats(node_t_stats_t *stats);
+
+/**
+ * @brief allocator of a process-wide `pool_t` sized for nodes, for the `_with_allocator` functions
+ *
+ * Nodes come from page-sized slabs through a magazine of the calling thread instead of one `malloc` each,
+ * for lists that often grow and shrink. Its memory is kept for the life of the process.
+ */
+const allocator_t *node_t_allocator(void);
+
+/**
+ * @brief `node_t_create` taking the node from `allocator`
+ *
+ * Nodes do not remember their allocator, lists built with one must be grown, shifted and destroyed
+ * with the `_with_allocator` functions and the same allocator.
+ *
+ * @param current Internal value for node.
+ * @param next Pointer to the next node.
+ * @param allocator Must outlive the node.
+ */
+node_t *node_t_create_with_allocator(void *current, node_t *next, const allocator_t *allocator);
+
+/**
+ * @brief `node_t_destroy` giving the nodes back to `allocator`
+ */
+void node_t_destroy_with_allocator(node_t *head, const allocator_t *allocator);
+
+/**
+ * @brief `node_t_unshift` taking the node from `allocator`
+ */
+void node_t_unshift_with_allocator(void *value, node_t **head, const allocator_t *allocator);
+
+/**
+ * @brief `node_t_shift` giving the node back to `allocator`
+ */
+void *node_t_shift_with_allocator(node_t **head, const allocator_t *allocator);
+
+/**
+ * @brief `node_t_push` taking the node from `allocator`
+ */
+node_t *node_t_push_with_allocator(void *value, node_t **tail, const allocator_t *allocator);
+
 #endif // NODE_H
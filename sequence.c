@@ -0,0 +1,430 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file sequence.c
+ * @brief Implementation of the indexed sequence backed by a B+tree
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "heap.h"
+#include "sequence.h"
+
+/**
+ * All leaves are at depth `height`, branches keep the number of members below each child.
+ * Nodes hold one more entry than their maximum, so an insert can overflow before splitting.
+ */
+#define SEQUENCE_LEAF 64
+#define SEQUENCE_FANOUT 32
+
+typedef struct sequence_leaf
+{
+  size_t count;
+  struct sequence_leaf *next;
+  void *items[SEQUENCE_LEAF + 1];
+} sequence_leaf;
+
+typedef struct
+{
+  size_t count;
+  size_t sizes[SEQUENCE_FANOUT + 1];
+  void *children[SEQUENCE_FANOUT + 1];
+} sequence_branch;
+
+struct sequence_t
+{
+  void *root;
+  size_t height;
+  size_t size;
+  sequence_leaf *first;
+};
+
+static sequence_leaf *sequence_leaf_create(void)
+{
+  sequence_leaf *leaf = malloc_realloc(sizeof(sequence_leaf), NULL);
+  leaf->count = 0;
+  leaf->next = NULL;
+
+  return leaf;
+}
+
+static sequence_branch *sequence_branch_create(void)
+{
+  sequence_branch *branch = malloc_realloc(sizeof(sequence_branch), NULL);
+  branch->count = 0;
+
+  return branch;
+}
+
+/**
+ * @brief number of entries of `node`, members of a leaf or children of a branch
+ */
+static inline size_t sequence_node_count(void *node, const size_t height)
+{
+  return height == 0 ? ((sequence_leaf *)node)->count : ((sequence_branch *)node)->count;
+}
+
+static size_t sequence_node_size(void *node, const size_t height)
+{
+  if (height == 0)
+    return ((sequence_leaf *)node)->count;
+
+  sequence_branch *branch = node;
+  size_t size = 0;
+
+  for (size_t i = 0; i < branch->count; i++)
+    size += branch->sizes[i];
+
+  return size;
+}
+
+static void sequence_node_destroy(void *node, const size_t height)
+{
+  if (height > 0)
+  {
+    sequence_branch *branch = node;
+
+    for (size_t i = 0; i < branch->count; i++)
+      sequence_node_destroy(branch->children[i], height - 1);
+  }
+
+  heap_free(node);
+}
+
+/**
+ * @brief finds the leaf holding `*index`, leaving in `*index` the position inside it
+ */
+static sequence_leaf *sequence_find(const sequence_t *s, size_t *index)
+{
+  void *node = s->root;
+
+  for (size_t height = s->height; height > 0; height--)
+  {
+    sequence_branch *branch = node;
+    size_t i = 0;
+
+    while (*index >= branch->sizes[i])
+      *index -= branch->sizes[i++];
+
+    node = branch->children[i];
+  }
+
+  return node;
+}
+
+/**
+ * @brief moves the upper half of an overflowing `node` to a new right sibling
+ */
+static void *sequence_split(void *node, const size_t height)
+{
+  if (height == 0)
+  {
+    sequence_leaf *leaf = node;
+    sequence_leaf *right = sequence_leaf_create();
+    size_t half = leaf->count / 2;
+
+    right->count = leaf->count - half;
+    memcpy(right->items, &leaf->items[half], right->count * sizeof(void *));
+    leaf->count = half;
+
+    right->next = leaf->next;
+    leaf->next = right;
+
+    return right;
+  }
+
+  sequence_branch *branch = node;
+  sequence_branch *right = sequence_branch_create();
+  size_t half = branch->count / 2;
+
+  right->count = branch->count - half;
+  memcpy(right->sizes, &branch->sizes[half], right->count * sizeof(size_t));
+  memcpy(right->children, &branch->children[half], right->count * sizeof(void *));
+  branch->count = half;
+
+  return right;
+}
+
+/**
+ * @brief inserts `item` at `index` below `node`
+ *
+ * @return the new right sibling when `node` had to split, `NULL` otherwise
+ */
+static void *sequence_insert_at(void *node, const size_t height, size_t index, void *item)
+{
+  if (height == 0)
+  {
+    sequence_leaf *leaf = node;
+
+    memmove(&leaf->items[index + 1], &leaf->items[index], (leaf->count - index) * sizeof(void *));
+    leaf->items[index] = item;
+    leaf->count++;
+
+    return leaf->count > SEQUENCE_LEAF ? sequence_split(leaf, 0) : NULL;
+  }
+
+  sequence_branch *branch = node;
+  size_t i = 0;
+
+  // positions at the end of a child append to it
+  while (i < branch->count - 1 && index > branch->sizes[i])
+    index -= branch->sizes[i++];
+
+  void *right = sequence_insert_at(branch->children[i], height - 1, index, item);
+  branch->sizes[i]++;
+
+  if (right == NULL)
+    return NULL;
+
+  size_t moved = branch->count - i - 1;
+
+  memmove(&branch->sizes[i + 2], &branch->sizes[i + 1], moved * sizeof(size_t));
+  memmove(&branch->children[i + 2], &branch->children[i + 1], moved * sizeof(void *));
+  branch->children[i + 1] = right;
+  branch->sizes[i + 1] = sequence_node_size(right, height - 1);
+  branch->sizes[i] -= branch->sizes[i + 1];
+  branch->count++;
+
+  return branch->count > SEQUENCE_FANOUT ? sequence_split(branch, height) : NULL;
+}
+
+/**
+ * @brief merges or evens out children `left` and `left + 1` of `branch`
+ */
+static void sequence_rebalance(sequence_branch *branch, const size_t height, const size_t left)
+{
+  void *a = branch->children[left];
+  void *b = branch->children[left + 1];
+  size_t max = height == 1 ? SEQUENCE_LEAF : SEQUENCE_FANOUT;
+  size_t count = sequence_node_count(a, height - 1) + sequence_node_count(b, height - 1);
+
+  if (height == 1)
+  {
+    sequence_leaf *l = a, *r = b;
+
+    if (count <= max)
+    {
+      memcpy(&l->items[l->count], r->items, r->count * sizeof(void *));
+      l->count = count;
+      l->next = r->next;
+    }
+    else if (l->count < r->count)
+    {
+      size_t moved = count / 2 - l->count;
+
+      memcpy(&l->items[l->count], r->items, moved * sizeof(void *));
+      memmove(r->items, &r->items[moved], (r->count - moved) * sizeof(void *));
+      l->count += moved;
+      r->count -= moved;
+    }
+    else
+    {
+      size_t moved = count / 2 - r->count;
+
+      memmove(&r->items[moved], r->items, r->count * sizeof(void *));
+      memcpy(r->items, &l->items[l->count - moved], moved * sizeof(void *));
+      l->count -= moved;
+      r->count += moved;
+    }
+  }
+  else
+  {
+    sequence_branch *l = a, *r = b;
+
+    if (count <= max)
+    {
+      memcpy(&l->sizes[l->count], r->sizes, r->count * sizeof(size_t));
+      memcpy(&l->children[l->count], r->children, r->count * sizeof(void *));
+      l->count = count;
+    }
+    else if (l->count < r->count)
+    {
+      size_t moved = count / 2 - l->count;
+
+      memcpy(&l->sizes[l->count], r->sizes, moved * sizeof(size_t));
+      memcpy(&l->children[l->count], r->children, moved * sizeof(void *));
+      memmove(r->sizes, &r->sizes[moved], (r->count - moved) * sizeof(size_t));
+      memmove(r->children, &r->children[moved], (r->count - moved) * sizeof(void *));
+      l->count += moved;
+      r->count -= moved;
+    }
+    else
+    {
+      size_t moved = count / 2 - r->count;
+
+      memmove(&r->sizes[moved], r->sizes, r->count * sizeof(size_t));
+      memmove(&r->children[moved], r->children, r->count * sizeof(void *));
+      memcpy(r->sizes, &l->sizes[l->count - moved], moved * sizeof(size_t));
+      memcpy(r->children, &l->children[l->count - moved], moved * sizeof(void *));
+      l->count -= moved;
+      r->count += moved;
+    }
+  }
+
+  if (count <= max)
+  {
+    // `b` is gone, its size joins `a`
+    branch->sizes[left] += branch->sizes[left + 1];
+    heap_free(b);
+
+    size_t moved = branch->count - left - 2;
+
+    memmove(&branch->sizes[left + 1], &branch->sizes[left + 2], moved * sizeof(size_t));
+    memmove(&branch->children[left + 1], &branch->children[left + 2], moved * sizeof(void *));
+    branch->count--;
+    return;
+  }
+
+  branch->sizes[left] = sequence_node_size(a, height - 1);
+  branch->sizes[left + 1] = sequence_node_size(b, height - 1);
+}
+
+/**
+ * @brief removes up to `count` members from `index` below `node`, stopping at the end of a leaf
+ *
+ * @return number of members removed
+ */
+static size_t sequence_remove_at(void *node, const size_t height, size_t index, const size_t count)
+{
+  if (height == 0)
+  {
+    sequence_leaf *leaf = node;
+    size_t removed = count < leaf->count - index ? count : leaf->count - index;
+
+    memmove(&leaf->items[index], &leaf->items[index + removed], (leaf->count - index - removed) * sizeof(void *));
+    leaf->count -= removed;
+
+    return removed;
+  }
+
+  sequence_branch *branch = node;
+  size_t i = 0;
+
+  while (index >= branch->sizes[i])
+    index -= branch->sizes[i++];
+
+  size_t removed = sequence_remove_at(branch->children[i], height - 1, index, count);
+  size_t min = (height == 1 ? SEQUENCE_LEAF : SEQUENCE_FANOUT) / 2;
+
+  branch->sizes[i] -= removed;
+
+  if (branch->count > 1 && sequence_node_count(branch->children[i], height - 1) < min)
+    sequence_rebalance(branch, height, i + 1 < branch->count ? i : i - 1);
+
+  return removed;
+}
+
+sequence_t *sequence_t_create(void)
+{
+  sequence_t *s = malloc_realloc(sizeof(sequence_t), NULL);
+
+  s->first = sequence_leaf_create();
+  s->root = s->first;
+  s->height = 0;
+  s->size = 0;
+
+  return s;
+}
+
+void sequence_t_destroy(sequence_t *s)
+{
+  if (s == NULL)
+    return;
+
+  sequence_node_destroy(s->root, s->height);
+  heap_free(s);
+}
+
+size_t sequence_t_size(const sequence_t *s)
+{
+  return s->size;
+}
+
+void *sequence_t_get(const sequence_t *s, const size_t index)
+{
+  if (index >= s->size)
+    return NULL;
+
+  size_t position = index;
+  sequence_leaf *leaf = sequence_find(s, &position);
+
+  return leaf->items[position];
+}
+
+void sequence_t_set(sequence_t *s, const size_t index, void *item)
+{
+  if (index >= s->size)
+    return;
+
+  size_t position = index;
+  sequence_leaf *leaf = sequence_find(s, &position);
+
+  leaf->items[position] = item;
+}
+
+void sequence_t_insert(sequence_t *s, const size_t index, void *item)
+{
+  void *right = sequence_insert_at(s->root, s->height, index < s->size ? index : s->size, item);
+
+  s->size++;
+
+  if (right == NULL)
+    return;
+
+  // the root split, the tree grows one level
+  sequence_branch *root = sequence_branch_create();
+
+  root->count = 2;
+  root->children[0] = s->root;
+  root->children[1] = right;
+  root->sizes[1] = sequence_node_size(right, s->height);
+  root->sizes[0] = s->size - root->sizes[1];
+
+  s->root = root;
+  s->height++;
+}
+
+void sequence_t_push(sequence_t *s, void *item)
+{
+  sequence_t_insert(s, s->size, item);
+}
+
+void sequence_t_remove(sequence_t *s, const size_t index, size_t count)
+{
+  if (index >= s->size)
+    return;
+
+  if (count > s->size - index)
+    count = s->size - index;
+
+  while (count > 0)
+  {
+    size_t removed = sequence_remove_at(s->root, s->height, index, count);
+
+    s->size -= removed;
+    count -= removed;
+
+    // a root left with a single child is replaced by it
+    while (s->height > 0 && ((sequence_branch *)s->root)->count == 1)
+    {
+      sequence_branch *root = s->root;
+
+      s->root = root->children[0];
+      s->height--;
+      heap_free(root);
+    }
+  }
+}
+
+void sequence_t_for_each(const sequence_t *s, sequence_t_visit visit, void *context)
+{
+  size_t index = 0;
+
+  for (sequence_leaf *leaf = s->first; leaf != NULL; leaf = leaf->next)
+    for (size_t i = 0; i < leaf->count; i++)
+      visit(leaf->items[i], index++, context);
+}
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file sequence.h
+ * @brief An indexed sequence backed by a B+tree, for edits in the middle of large sequences
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stddef.h>
+
+#ifndef SEQUENCE_H
+#define SEQUENCE_H
+
+/**
+ * @brief indexed sequence container
+ *
+ * Members are pointers kept in fixed-size leaf chunks of a B+tree whose branches count the members
+ * below them, so positions are found, inserted and removed in `O(log n)` instead of shifting the tail
+ * as `vector_t` does. Reading by index is `O(log n)` too, prefer `sequence_t_for_each` to go through all of them.
+ */
+typedef struct sequence_t sequence_t;
+
+/**
+ * @brief callback for `sequence_t_for_each`
+ *
+ * @param[in] item member
+ * @param[in] index position of the member
+ * @param[in] context pointer given to `sequence_t_for_each`
+ */
+typedef void (*sequence_t_visit)(void *item, const size_t index, void *context);
+
+/**
+ * @brief creates a new empty `sequence_t`
+ *
+ * @return `sequence_t*` pointer for created sequence
+ */
+sequence_t *sequence_t_create(void);
+
+/**
+ * @brief destroys `sequence_t`, members are not freed
+ *
+ * @param[in] sequence
+ */
+void sequence_t_destroy(sequence_t *sequence);
+
+/**
+ * @brief retrieves the number of members of `sequence_t`
+ *
+ * @note `O(1)`
+ *
+ * @param[in] sequence
+ */
+size_t sequence_t_size(const sequence_t *sequence);
+
+/**
+ * @brief retrieves member at `index`
+ *
+ * @note `O(log n)`
+ *
+ * @param[in] sequence
+ * @param[in] index
+ * @return `void*` the member, `NULL` when out of bounds
+ */
+void *sequence_t_get(const sequence_t *sequence, const size_t index);
+
+/**
+ * @brief replaces member at `index`, does nothing when out of bounds
+ *
+ * @note `O(log n)`
+ *
+ * @param[in] sequence
+ * @param[in] index
+ * @param[in] item
+ */
+void sequence_t_set(sequence_t *sequence, const size_t index, void *item);
+
+/**
+ * @brief inserts member at `index`, moving the following ones one position up
+ *
+ * @note `O(log n)`
+ *
+ * @param[in] sequence
+ * @param[in] index appends when past the last member
+ * @param[in] item
+ */
+void sequence_t_insert(sequence_t *sequence, const size_t index, void *item);
+
+/**
+ * @brief inserts member after the last one of `sequence_t`
+ *
+ * @note `O(log n)`
+ *
+ * @param[in] sequence
+ * @param[in] item
+ */
+void sequence_t_push(sequence_t *sequence, void *item);
+
+/**
+ * @brief removes `count` members starting at `index`, moving the following ones down
+ *
+ * @note `O(log n)` per leaf chunk touched
+ *
+ * @param[in] sequence
+ * @param[in] index start index, inclusive
+ * @param[in] count how many to remove
+ */
+void sequence_t_remove(sequence_t *sequence, const size_t index, size_t count);
+
+/**
+ * @brief visits all members in order, one leaf chunk after the other
+ *
+ * @note `O(n)`
+ *
+ * @param[in] sequence
+ * @param[in] visit
+ * @param[in] context passed to `visit`
+ */
+void sequence_t_for_each(const sequence_t *sequence, sequence_t_visit visit, void *context);
+
+#endif // SEQUENCE_H
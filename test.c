@@ -9,12 +9,26 @@
  */
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdint.h>
+#include <string.h>
 #include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/resource.h>
 #include "test.h"
 #include "heap.h"
 #include "vector.h"
+#include "vector_type.h"
 #include "matrix.h"
+#include "vector_io.h"
 #include "node.h"
+#include "list.h"
+#include "deque.h"
+#include "cvector.h"
+#include "sequence.h"
+#include "ulist.h"
+#include <pthread.h>
 
 typedef struct
 {
@@ -23,7 +37,15 @@ typedef struct
 
 int tests_ran = 0;
 
+VECTOR_DEFINE(int_vector, int)
+
 typedef void (*vector_t_operate)(vector_t *, size_t);
+typedef void (*int_vector_operate)(int_vector_t *, size_t);
+typedef void (*deque_t_operate)(deque_t *, size_t);
+typedef void (*sequence_t_operate)(sequence_t *, size_t);
+typedef void (*arena_operate)(arena_t *, size_t);
+typedef void (*node_t_operate)(const allocator_t *, size_t);
+typedef void (*list_t_operate)(list_t *, size_t);
 
 static int with_elapsed(vector_t *v, size_t s, vector_t_operate f)
 {
@@ -36,6 +58,80 @@ static int with_elapsed(vector_t *v, size_t s, vector_t_operate f)
   return (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
 }
 
+static int with_elapsed_int_vector(int_vector_t *v, size_t s, int_vector_operate f)
+{
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  f(v, s);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+}
+
+static int with_elapsed_deque(deque_t *d, size_t s, deque_t_operate f)
+{
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  f(d, s);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+}
+
+static int with_elapsed_arena(arena_t *a, size_t s, arena_operate f)
+{
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  f(a, s);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+}
+
+static int with_elapsed_node(const allocator_t *a, size_t s, node_t_operate f)
+{
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  f(a, s);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+}
+
+static int with_elapsed_list(list_t *l, size_t s, list_t_operate f)
+{
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  f(l, s);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+}
+
+static int with_elapsed_sequence(sequence_t *q, size_t s, sequence_t_operate f)
+{
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  f(q, s);
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+}
+
+/**
+ * @brief prints timings kept for comparison, which one is faster at ms resolution is up to the scheduler
+ */
+static void report(const char *benchmark, const int elapsed, const char *baseline, const int baseline_elapsed)
+{
+  printf("%s: %dms, %s: %dms\n", benchmark, elapsed, baseline, baseline_elapsed);
+}
+
 static char *test_vector_t_create()
 {
   vector_t *v = vector_t_create(0);
@@ -380,155 +476,2334 @@ static char *test_vector_t_clean()
   return 0;
 }
 
-static void vector_t_insert_batch(vector_t *v, size_t size)
+static char *test_vector_t_capacity()
 {
-  t_test s1 = {100000000};
+  vector_t *v = vector_t_create(0);
+  t_test s1 = {42};
 
-  for (int i = 0; i < size; i++)
-  {
-    vector_t_insert(v, i, &s1);
-  }
+  expect("vector_t_length (0)", vector_t_length(v) == 0);
+  expect("vector_t_capacity (0)", vector_t_capacity(v) == 0);
+
+  vector_t_reserve(v, 100);
+  expect("vector_t_reserve size", vector_t_size(v) == 0);
+  expect("vector_t_reserve capacity", vector_t_capacity(v) == 100);
+
+  // byte counts past `SIZE_MAX` are refused instead of wrapping
+  expect("vector_t_reserve (overflow)", vector_t_reserve(v, SIZE_MAX / 4) == -1 && vector_t_capacity(v) == 100);
+  vector_t_set(v, SIZE_MAX / 2, &s1);
+  expect("vector_t_set (overflow)", vector_t_size(v) == 0 && vector_t_capacity(v) == 100);
+  expect("vector_t_create_sized (overflow)", vector_t_create_sized(SIZE_MAX / 4, 8) == NULL);
+
+  for (size_t i = 0; i < 101; i++)
+    vector_t_push(v, &s1);
+
+  expect("vector_t_push size", vector_t_size(v) == 101);
+  expect("vector_t_push length", vector_t_length(v) == 101);
+  expect("vector_t_push capacity", vector_t_capacity(v) >= 101);
+
+  vector_t_set(v, 100, NULL);
+  vector_t_set(v, 99, NULL);
+  expect("vector_t_set length", vector_t_length(v) == 99);
+  expect("vector_t_set size", vector_t_size(v) == 101);
+
+  vector_t_remove(v, 50, 100);
+  expect("vector_t_remove length", vector_t_length(v) == 50);
+
+  vector_t_push(v, &s1);
+  expect("vector_t_push length", vector_t_length(v) == 51);
+  expect("vector_t_get (50) == s1", ((t_test *)vector_t_get(v, 50))->id == s1.id);
+
+  vector_t_resize(v, vector_t_length(v));
+  vector_t_shrink_to_fit(v);
+  expect("vector_t_shrink_to_fit size", vector_t_size(v) == 51);
+  expect("vector_t_shrink_to_fit capacity", vector_t_capacity(v) == 51);
+
+  vector_t_clean(v);
+  expect("vector_t_clean length", vector_t_length(v) == 0);
+
+  vector_t_destroy(v);
+
+  return 0;
 }
 
-static void vector_t_push_batch(vector_t *v, size_t size)
+static char *test_vector_t_small()
 {
-  t_test s1 = {100000000};
+  vector_t *v = vector_t_create(3);
+  vector_t *sized = vector_t_create_sized(sizeof(int), 0);
+  t_test s[10];
 
-  for (int i = 0; i < size; i++)
+  for (int i = 0; i < 10; i++)
+    s[i].id = i;
+
+  // fills the inline members then spills past them
+  for (size_t i = 0; i < 10; i++)
   {
-    vector_t_push(v, &s1);
+    vector_t_push(v, &s[i]);
+
+    for (size_t j = 0; j <= i; j++)
+      expect("vector_t_push (small)", vector_t_get(v, j) == &s[j]);
   }
-}
 
-static void vector_t_remove_batch(vector_t *v, size_t size)
-{
-  vector_t_remove(v, 0, size);
-}
+  vector_t_remove(v, 2, 5);
+  vector_t_compact(v);
+  vector_t_resize(v, vector_t_length(v));
+  vector_t_shrink_to_fit(v);
+  expect("vector_t_shrink_to_fit (small)", vector_t_capacity(v) == 5);
+  expect("vector_t_get (small)", vector_t_get(v, 1) == &s[1] && vector_t_get(v, 2) == &s[7]);
 
-static char *test_vector_t_performance()
-{
-  vector_t *v = vector_t_create(1000000);
-  int elapsed;
+  vector_t_insert(v, 0, &s[9]);
+  expect("vector_t_insert (small)", vector_t_get(v, 0) == &s[9] && vector_t_get(v, 5) == &s[9]);
 
-  elapsed = with_elapsed(v, 1000000, vector_t_insert_batch);
-  expect("vector_t_insert_batch < 10ms", elapsed < 10);
-  expect("vector_t_insert_batch size", vector_t_size(v) == 1000000);
+  for (int i = 0; i < 40; i++)
+  {
+    vector_t_push(sized, &i);
+    expect("vector_t_push (small sized)", *(int *)vector_t_get(sized, 0) == 0);
+    expect("vector_t_push (small sized)", *(int *)vector_t_get(sized, i) == i);
+  }
 
-  elapsed = with_elapsed(v, 100000, vector_t_push_batch);
-  expect("vector_t_push_batch < 50ms", elapsed < 50);
-  expect("vector_t_push_batch size", vector_t_size(v) == 1100000);
+  vector_t_resize(sized, 3);
+  vector_t_shrink_to_fit(sized);
+  expect("vector_t_shrink_to_fit (small sized)", *(int *)vector_t_get(sized, 2) == 2);
 
-  elapsed = with_elapsed(v, 100000, vector_t_remove_batch);
-  expect("vector_t_remove_batch < 50ms", elapsed < 50);
-  expect("vector_t_remove_batch size", vector_t_size(v) == 1100000);
-  expect("vector_t_remove_batch compact", vector_t_compact(v) == 1000000);
+  vector_t_resize(sized, 0);
+  vector_t_shrink_to_fit(sized);
+  expect("vector_t_shrink_to_fit (empty)", vector_t_capacity(sized) == 0);
 
+  vector_t_destroy(sized);
   vector_t_destroy(v);
 
   return 0;
 }
 
-static char *test_vector_t_iterator()
+static char *test_vector_t_align()
 {
-  vector_t *v = vector_t_create(1000000);
-  vector_t_insert_batch(v, 1000000);
+  vector_t *v = vector_t_create_sized(sizeof(double), 3);
+  double d = 0.5;
 
-  vector_t_iterator *i = vector_t_iterator_create(v);
-  void *t = NULL;
+  vector_t_set(v, 2, &d);
+  vector_t_align(v, 64);
+  expect("vector_t_align (small)", (uintptr_t)vector_t_get(v, 0) % 64 == 0);
+  expect("vector_t_align (small) get", *(double *)vector_t_get(v, 2) == d);
 
-  while ((t = vector_t_iterator_next(i)) != NULL)
+  for (int i = 0; i < 10000; i++)
   {
-    expect("vector_t_iterator_next < 1000000", vector_t_iterator_cursor(i) < 1000000);
+    d = i;
+    vector_t_push(v, &d);
+    expect("vector_t_align (push)", (uintptr_t)vector_t_get(v, 0) % 64 == 0);
   }
 
-  vector_t_iterator_reset(i);
-  expect("vector_t_iterator_reset", vector_t_iterator_cursor(i) == 0);
+  vector_t_resize(v, 5);
+  vector_t_shrink_to_fit(v);
+  expect("vector_t_align (shrink)", (uintptr_t)vector_t_get(v, 0) % 64 == 0);
+  expect("vector_t_align (shrink) get", *(double *)vector_t_get(v, 4) == 1.0);
+
+  vector_t_align(v, 4096);
+  expect("vector_t_align (4096)", (uintptr_t)vector_t_get(v, 0) % 4096 == 0);
+  expect("vector_t_align (4096) get", *(double *)vector_t_get(v, 2) == 0.5);
 
   vector_t_destroy(v);
-  vector_t_iterator_destroy(i);
+
+  // grows past the huge page threshold, then drops back below it
+  v = vector_t_create_sized(sizeof(size_t), 0);
+  vector_t_huge_pages(v, 1);
+
+  for (size_t i = 0; i < 1000000; i++)
+    vector_t_push(v, &i);
+
+  expect("vector_t_huge_pages (mapped)", (uintptr_t)vector_t_get(v, 0) % 4096 == 0);
+
+  vector_t *copy = vector_t_copy(v);
+
+  for (size_t i = 0; i < 1000000; i += 997)
+    expect("vector_t_huge_pages get", *(size_t *)vector_t_get(v, i) == i && *(size_t *)vector_t_get(copy, i) == i);
+
+  vector_t_huge_pages(copy, 0);
+  vector_t_destroy(copy);
+
+  vector_t_resize(v, 1000);
+  vector_t_shrink_to_fit(v);
+  expect("vector_t_huge_pages (shrink) get", *(size_t *)vector_t_get(v, 999) == 999);
+
+  vector_t_destroy(v);
+
+  matrix_t *m = matrix_t_create_sized(sizeof(float), 512, 1024);
+  matrix_t_huge_pages(m, 1);
+  matrix_t_align(m, 64);
+  matrix_t_resize(m, 1024, 1024);
+  expect("matrix_t_huge_pages", (uintptr_t)matrix_t_get(m, 0, 0) % 4096 == 0);
+  expect("matrix_t_huge_pages get", *(float *)matrix_t_get(m, 1023, 1023) == 0.0f);
+  matrix_t_destroy(m);
 
   return 0;
 }
 
-static char *test_matrix_t()
+static char *test_vector_t_open_mmap()
 {
-  matrix_t *m = matrix_t_create(2, 3);
+  char path[] = "/tmp/vector_t_open_mmap_XXXXXX";
+  int fd = mkstemp(path);
+  expect("mkstemp", fd >= 0);
+  close(fd);
 
-  expect("matrix_t_cols", matrix_t_cols(m) == 3);
-  expect("matrix_t_rows", matrix_t_rows(m) == 2);
+  vector_t *v = vector_t_open_mmap(path, sizeof(int));
+  expect("vector_t_open_mmap (new)", v != NULL && vector_t_size(v) == 0);
 
-  int s[20] = {1, 2, 3, 4, 5, 6};
+  for (int i = 0; i < 100000; i++)
+    vector_t_push(v, &i);
 
-  for (size_t i = 0; i < matrix_t_rows(m); i++)
-    for (size_t j = 0; j < matrix_t_cols(m); j++)
-      matrix_t_set(m, i, j, &s[i * matrix_t_cols(m) + j]);
+  vector_t_remove(v, 0, 1);
+  expect("vector_t_sync", vector_t_sync(v) == 0);
+  vector_t_destroy(v);
 
-  for (size_t i = 0; i < matrix_t_rows(m); i++)
-    for (size_t j = 0; j < matrix_t_cols(m); j++)
-      expect("matrix_t_set", (*(int *)matrix_t_get(m, i, j)) == s[matrix_t_idx(m, i, j)]);
+  expect("vector_t_open_mmap (width)", vector_t_open_mmap(path, sizeof(long long)) == NULL);
 
-  matrix_t_remove(m, 0, 0);
-  expect("matrix_t_remove", matrix_t_get(m, 1, 2) == NULL);
+  v = vector_t_open_mmap(path, sizeof(int));
+  expect("vector_t_open_mmap (existing)", v != NULL && vector_t_size(v) == 99999);
 
-  matrix_t_resize(m, 3, 4);
+  for (size_t i = 0; i < vector_t_size(v); i++)
+    expect("vector_t_open_mmap get", *(int *)vector_t_get(v, i) == (int)i + 1);
 
-  expect("matrix_t_cols", matrix_t_cols(m) == 4);
-  expect("matrix_t_rows", matrix_t_rows(m) == 3);
+  vector_t_resize(v, 10);
+  vector_t_shrink_to_fit(v);
+  vector_t_destroy(v);
 
-  matrix_t_remove_row(m, 1);
+  v = vector_t_open_mmap(path, sizeof(int));
+  expect("vector_t_open_mmap (shrunk)", v != NULL && vector_t_size(v) == 10);
+  expect("vector_t_open_mmap get", *(int *)vector_t_get(v, 9) == 10);
 
-  for (size_t i = 0; i < matrix_t_cols(m); i++)
-    expect("matrix_t_remove_row", matrix_t_get(m, matrix_t_rows(m) - 1, i) == NULL);
+  // the file can not grow past the limit, writers stop at the mapped capacity
+  struct rlimit limit, small = {4096, 4096};
+  getrlimit(RLIMIT_FSIZE, &limit);
+  small.rlim_max = limit.rlim_max;
+  signal(SIGXFSZ, SIG_IGN);
+  setrlimit(RLIMIT_FSIZE, &small);
 
-  expect("matrix_t_col", matrix_t_col(m, 2) == 2);
-  expect("matrix_t_row", matrix_t_row(m, 2) == 0);
+  size_t capacity = vector_t_capacity(v);
+  expect("vector_t_reserve (mapped failure)", vector_t_reserve(v, 100000) == -1 && vector_t_capacity(v) == capacity);
 
-  expect("matrix_t_col", matrix_t_col(m, 9) == 1);
-  expect("matrix_t_row", matrix_t_row(m, 9) == 2);
+  for (int i = 0; i < 2000; i++)
+    vector_t_push(v, &i);
+
+  expect("vector_t_push (mapped failure)", vector_t_size(v) <= vector_t_capacity(v) && vector_t_size(v) < 2010);
+  vector_t_set(v, 100000, NULL);
+  expect("vector_t_set (mapped failure)", vector_t_size(v) < 100000);
+
+  setrlimit(RLIMIT_FSIZE, &limit);
+  signal(SIGXFSZ, SIG_DFL);
+  vector_t_destroy(v);
+
+  unlink(path);
+
+  return 0;
+}
+
+static char *test_vector_t_save_load()
+{
+  char path[] = "/tmp/vector_t_save_XXXXXX";
+  int fd = mkstemp(path);
+  expect("mkstemp", fd >= 0);
+  close(fd);
+
+  vector_t *v = vector_t_create_sized(sizeof(int), 0);
+  vector_t *p = vector_t_create(1);
+
+  for (int i = 0; i < 100000; i++)
+    vector_t_push(v, &i);
+
+  expect("vector_t_save (pointers)", vector_t_save(p, path) == -1);
+  expect("vector_t_load (empty file)", vector_t_load(path) == NULL);
+  expect("vector_t_save", vector_t_save(v, path) == 0);
+
+  vector_t *loaded = vector_t_load(path);
+  expect("vector_t_load", loaded != NULL && vector_t_size(loaded) == 100000);
+  expect("vector_t_load element_size", vector_t_element_size(loaded) == sizeof(int));
+
+  for (size_t i = 0; i < vector_t_size(loaded); i++)
+    expect("vector_t_load get", *(int *)vector_t_get(loaded, i) == (int)i);
+
+  // streams the snapshot in chunks of 4096 members
+  vector_t_reader *reader = vector_t_reader_open(path);
+  int chunk[4096];
+  size_t total = 0, read;
+
+  expect("vector_t_reader_open", reader != NULL);
+  expect("vector_t_reader_count", vector_t_reader_count(reader) == 100000);
+  expect("vector_t_reader_width", vector_t_reader_width(reader) == sizeof(int));
+
+  while ((read = vector_t_reader_read(reader, chunk, 4096)) > 0)
+  {
+    for (size_t i = 0; i < read; i++)
+      expect("vector_t_reader_read", chunk[i] == (int)(total + i));
+
+    total += read;
+  }
+
+  expect("vector_t_reader_read total", total == 100000);
+  vector_t_reader_close(reader);
+
+  matrix_t *m = matrix_t_load(path);
+  expect("matrix_t_load (vector)", m != NULL && matrix_t_rows(m) == 1 && matrix_t_cols(m) == 100000);
+  expect("matrix_t_load (vector) get", *(int *)matrix_t_get(m, 0, 99999) == 99999);
+  matrix_t_destroy(m);
+
+  m = matrix_t_create_sized(sizeof(double), 3, 4);
+
+  for (size_t i = 0; i < 3; i++)
+    for (size_t j = 0; j < 4; j++)
+    {
+      double d = i * 10.0 + j;
+      matrix_t_set(m, i, j, &d);
+    }
+
+  expect("matrix_t_save", matrix_t_save(m, path) == 0);
+  matrix_t_destroy(m);
+
+  m = matrix_t_load(path);
+  expect("matrix_t_load", m != NULL && matrix_t_rows(m) == 3 && matrix_t_cols(m) == 4);
+  expect("matrix_t_load get", *(double *)matrix_t_get(m, 2, 3) == 23.0);
+  matrix_t_destroy(m);
+
+  // removed cells are saved as zeros, the matrix itself is left as is
+  m = matrix_t_load(path);
+  matrix_t_remove(m, 2, 3);
+  expect("matrix_t_save (removed)", matrix_t_save(m, path) == 0 && matrix_t_get(m, 2, 3) == NULL);
+  matrix_t_destroy(m);
 
+  m = matrix_t_load(path);
+  expect("matrix_t_load (removed)", m != NULL && *(double *)matrix_t_get(m, 2, 3) == 0.0);
+  expect("matrix_t_load (removed) get", *(double *)matrix_t_get(m, 2, 2) == 22.0);
   matrix_t_destroy(m);
 
+  vector_t_destroy(loaded);
+  loaded = vector_t_load(path);
+  expect("vector_t_load (matrix)", loaded != NULL && vector_t_size(loaded) == 12);
+  expect("vector_t_load (matrix) get", *(double *)vector_t_get(loaded, 5) == 11.0);
+
+  // corrupt headers claiming more members than the file holds, or rows * cols wrapping around to count
+  vector_io_header header;
+  fd = open(path, O_RDWR);
+  expect("pread header", pread(fd, &header, sizeof(header), 0) == sizeof(header));
+  header.count = (uint64_t)1 << 44;
+  pwrite(fd, &header, sizeof(header), 0);
+  expect("vector_t_load (corrupt count)", vector_t_load(path) == NULL);
+  expect("vector_t_reader_open (corrupt count)", vector_t_reader_open(path) == NULL);
+
+  header.count = 12;
+  header.rows = ((uint64_t)1 << 63) + 6;
+  header.cols = 2;
+  pwrite(fd, &header, sizeof(header), 0);
+  expect("matrix_t_load (corrupt rows)", matrix_t_load(path) == NULL);
+  close(fd);
+
+  expect("vector_t_create_sized (no memory)", vector_t_create_sized(1 << 20, (size_t)1 << 40) == NULL);
+
+  m = matrix_t_create(1, 1);
+  expect("matrix_t_save (pointers)", matrix_t_save(m, path) == -1);
+  matrix_t_destroy(m);
+
+  unlink(path);
+  vector_t_destroy(loaded);
+  vector_t_destroy(p);
+  vector_t_destroy(v);
+
   return 0;
 }
 
-static char *test_node_t()
+static void t_test_increment(void *item, const size_t index, void *context)
 {
-  int s[4] = {1, 37, 42, 101};
+  (*(int *)item)++;
+}
 
-  node_t *head = node_t_create(&s[2], NULL);
-  node_t *tail = NULL;
-  node_t *iter = NULL;
+static char *test_vector_t_sized()
+{
+  vector_t *v = vector_t_create_sized(sizeof(int), 3);
+  int n[5] = {1, 37, 42, 101, 7};
 
-  expect("node_t_peek", (*(int *)node_t_peek(head)) == s[2]);
-  expect("node_t_peek", (*(int *)node_t_peek(head)) == s[2]);
+  expect("vector_t_element_size", vector_t_element_size(v) == sizeof(int));
+  expect("vector_t_size (3)", vector_t_size(v) == 3);
+  expect("vector_t_get (0) == 0", *(int *)vector_t_get(v, 0) == 0);
+
+  vector_t_set(v, 0, &n[0]);
+  vector_t_set(v, 1, &n[1]);
+  vector_t_set(v, 2, &n[2]);
+  n[0] = 1000;
+  expect("vector_t_set copies", *(int *)vector_t_get(v, 0) == 1);
+
+  vector_t_insert(v, 1, &n[3]);
+  expect("vector_t_insert size", vector_t_size(v) == 4);
+  expect("vector_t_get (1) == 101", *(int *)vector_t_get(v, 1) == 101);
+  expect("vector_t_get (2) == 37", *(int *)vector_t_get(v, 2) == 37);
+  expect("vector_t_get (3) == 42", *(int *)vector_t_get(v, 3) == 42);
+
+  vector_t_push(v, &n[4]);
+  expect("vector_t_push size", vector_t_size(v) == 5);
+  expect("vector_t_length", vector_t_length(v) == 5);
+  expect("vector_t_get (4) == 7", *(int *)vector_t_get(v, 4) == 7);
+
+  vector_t_remove(v, 1, 2);
+  expect("vector_t_remove size", vector_t_size(v) == 3);
+  expect("vector_t_get (0) == 1", *(int *)vector_t_get(v, 0) == 1);
+  expect("vector_t_get (1) == 42", *(int *)vector_t_get(v, 1) == 42);
+  expect("vector_t_get (2) == 7", *(int *)vector_t_get(v, 2) == 7);
+  expect("vector_t_get (3) == NULL", vector_t_get(v, 3) == NULL);
+
+  vector_t_swap(v, 0, 2);
+  expect("vector_t_swap (0)", *(int *)vector_t_get(v, 0) == 7);
+  expect("vector_t_swap (2)", *(int *)vector_t_get(v, 2) == 1);
 
-  node_t_unshift(&s[1], &head);
-  expect("node_t_unshift", (*(int *)node_t_peek(head)) == s[1]);
+  vector_t *vv = vector_t_copy(v);
+  vector_t_reverse(vv);
+  expect("vector_t_copy size", vector_t_size(vv) == 3);
+  expect("vector_t_reverse (0)", *(int *)vector_t_get(vv, 0) == 1);
+  expect("vector_t_reverse (2)", *(int *)vector_t_get(vv, 2) == 7);
+  expect("vector_t_copy original", *(int *)vector_t_get(v, 0) == 7);
+
+  // visitors may write members, the shared buffer is taken first
+  vector_t_for_each(vv, t_test_increment, NULL);
+  expect("vector_t_for_each (copy)", *(int *)vector_t_get(vv, 0) == 2);
+  expect("vector_t_for_each original", *(int *)vector_t_get(v, 2) == 1);
+
+  vector_t *empty = vector_t_create_sized(sizeof(int), 1);
+  vector_t_resize(empty, 0);
+  vector_t_shrink_to_fit(empty);
+  vector_t *empty_copy = vector_t_copy(empty);
+  expect("vector_t_copy (empty)", empty_copy != NULL && vector_t_size(empty_copy) == 0);
+  vector_t_destroy(empty_copy);
+  vector_t_destroy(empty);
+
+  vector_t_set(v, 5, &n[4]);
+  expect("vector_t_set (5) size", vector_t_size(v) == 6);
+  expect("vector_t_get (4) == 0", *(int *)vector_t_get(v, 4) == 0);
+  expect("vector_t_compact", vector_t_compact(v) == 6);
 
-  expect("node_t_shift", (*(int *)node_t_shift(&head)) == s[1]);
-  expect("node_t_shift", (*(int *)node_t_peek(head)) == s[2]);
+  vector_t_destroy(vv);
+  vector_t_destroy(v);
 
-  node_t_unshift(&s[1], &head);
-  expect("node_t_unshift", (*(int *)node_t_peek(head)) == s[1]);
+  return 0;
+}
 
-  node_t_unshift(&s[0], &head);
-  expect("node_t_unshift", (*(int *)node_t_peek(head)) == s[0]);
+static char *test_vector_t_bulk()
+{
+  vector_t *v = vector_t_create(0);
+  t_test s[4] = {{1}, {37}, {42}, {101}};
+  void *items[4] = {&s[0], &s[1], &s[2], &s[3]};
+
+  vector_t_push_n(v, items, 4);
+  expect("vector_t_push_n size", vector_t_size(v) == 4);
+  expect("vector_t_push_n length", vector_t_length(v) == 4);
+  expect("vector_t_get (3) == s3", ((t_test *)vector_t_get(v, 3))->id == s[3].id);
+
+  vector_t_insert_range(v, 1, items, 2);
+  expect("vector_t_insert_range size", vector_t_size(v) == 6);
+  expect("vector_t_get (0) == s0", ((t_test *)vector_t_get(v, 0))->id == s[0].id);
+  expect("vector_t_get (1) == s0", ((t_test *)vector_t_get(v, 1))->id == s[0].id);
+  expect("vector_t_get (2) == s1", ((t_test *)vector_t_get(v, 2))->id == s[1].id);
+  expect("vector_t_get (3) == s1", ((t_test *)vector_t_get(v, 3))->id == s[1].id);
+  expect("vector_t_get (5) == s3", ((t_test *)vector_t_get(v, 5))->id == s[3].id);
+
+  vector_t_insert_range(v, 8, items, 1);
+  expect("vector_t_insert_range (8) size", vector_t_size(v) == 9);
+  expect("vector_t_get (6) == NULL", vector_t_get(v, 6) == NULL);
+  expect("vector_t_get (8) == s0", ((t_test *)vector_t_get(v, 8))->id == s[0].id);
+
+  vector_t_append_vector(v, v);
+  expect("vector_t_append_vector size", vector_t_size(v) == 18);
+  expect("vector_t_append_vector length", vector_t_length(v) == 18);
+  expect("vector_t_get (17) == s0", ((t_test *)vector_t_get(v, 17))->id == s[0].id);
+  expect("vector_t_get (15) == NULL", vector_t_get(v, 15) == NULL);
+
+  vector_t *sized = vector_t_create_sized(sizeof(int), 0);
+  int n[3] = {1, 2, 3};
+
+  vector_t_push_n(sized, n, 3);
+  vector_t_insert_range(sized, 0, n, 2);
+  expect("vector_t_insert_range sized size", vector_t_size(sized) == 5);
+  expect("vector_t_get (1) == 2", *(int *)vector_t_get(sized, 1) == 2);
+  expect("vector_t_get (2) == 1", *(int *)vector_t_get(sized, 2) == 1);
+  expect("vector_t_get (4) == 3", *(int *)vector_t_get(sized, 4) == 3);
+
+  vector_t_append_vector(sized, v);
+  expect("vector_t_append_vector mismatch", vector_t_size(sized) == 5);
+
+  vector_t_destroy(sized);
+  vector_t_destroy(v);
 
-  tail = node_t_push(&s[3], &head);
-  expect("node_t_push", (*(int *)node_t_peek(head)) == s[0]);
-  expect("node_t_push", (*(int *)node_t_peek(tail)) == s[3]);
+  return 0;
+}
 
-  iter = head;
-  for (size_t i = 0; i < sizeof(s) / sizeof(s[0]); i++)
+static char *test_vector_t_bitmap()
+{
+  vector_t *v = vector_t_create(0);
+  vector_t *b = vector_t_create(0);
+  t_test s[3] = {{1}, {37}, {42}};
+
+  vector_t_bitmap(b, 1);
+
+  // same operations on both, with and without the bitmap
+  for (size_t i = 0; i < 1000; i++)
   {
-    expect("iter", (*(int *)node_t_peek(iter)) == s[i]);
-    iter = node_t_next(iter); 
+    vector_t *t = i % 2 ? b : v;
+
+    for (int j = 0; j < 2; j++, t = t == v ? b : v)
+    {
+      switch ((i * 7) % 9)
+      {
+      case 0:
+        vector_t_push(t, &s[i % 3]);
+        break;
+      case 1:
+        vector_t_set(t, (i * 13) % 300, i % 4 ? &s[1] : NULL);
+        break;
+      case 2:
+        vector_t_insert(t, (i * 17) % 200, &s[2]);
+        break;
+      case 3:
+        vector_t_remove(t, (i * 11) % 150, i % 5);
+        break;
+      case 4:
+        vector_t_swap(t, i % 70, (i * 3) % 90);
+        break;
+      case 5:
+        vector_t_move(t, i % 50, (i * 5) % 80);
+        break;
+      case 6:
+        if (i % 4 == 0)
+          vector_t_compact(t);
+        else
+          vector_t_reverse(t);
+        break;
+      case 7:
+        vector_t_resize(t, vector_t_size(t) - (vector_t_size(t) / 10));
+        break;
+      default:
+        vector_t_push(t, NULL);
+      }
+    }
+
+    expect("vector_t_bitmap size", vector_t_size(v) == vector_t_size(b));
+    expect("vector_t_bitmap length", vector_t_length(v) == vector_t_length(b));
+    expect("vector_t_bitmap count", vector_t_count(v) == vector_t_count(b));
+    expect("vector_t_bitmap first_free", vector_t_first_free(v) == vector_t_first_free(b));
   }
 
-  expect("node_t_size", node_t_size(head) == 4);
-  expect("node_t_size", node_t_size(head) == 4);
+  for (size_t i = 0; i < vector_t_size(v); i++)
+    expect("vector_t_bitmap get", vector_t_get(v, i) == vector_t_get(b, i));
+
+  expect("vector_t_bitmap compact", vector_t_compact(b) == vector_t_count(v));
+  expect("vector_t_bitmap compact length", vector_t_length(b) == vector_t_count(v));
+  expect("vector_t_bitmap first_free", vector_t_first_free(b) == vector_t_count(v));
+
+  vector_t_clean(b);
+  expect("vector_t_bitmap clean", vector_t_count(b) == 0);
+
+  vector_t_destroy(b);
+  vector_t_destroy(v);
+
+  return 0;
+}
+
+static int t_test_compare(const void *a, const void *b)
+{
+  return ((const t_test *)a)->id - ((const t_test *)b)->id;
+}
+
+static int int_compare(const void *a, const void *b)
+{
+  return *(const int *)a - *(const int *)b;
+}
+
+/**
+ * @brief applies mutation `op` of the copy-on-write test to `v`
+ */
+static void t_test_mutate(vector_t *v, const int op, void *item)
+{
+  void *items[3] = {item, item, item};
+
+  switch (op)
+  {
+  case 0:
+    vector_t_set(v, 3, item);
+    break;
+  case 1:
+    vector_t_insert(v, 1, item);
+    break;
+  case 2:
+    vector_t_remove(v, 0, 2);
+    break;
+  case 3:
+    vector_t_push(v, item);
+    break;
+  case 4:
+    vector_t_push_n(v, vector_t_element_size(v) > 0 ? item : (void *)items, 1);
+    break;
+  case 5:
+    vector_t_insert_range(v, 2, vector_t_element_size(v) > 0 ? item : (void *)items, 1);
+    break;
+  case 6:
+    vector_t_resize(v, 5);
+    break;
+  case 7:
+    vector_t_resize(v, 200);
+    vector_t_set(v, 150, item);
+    break;
+  case 8:
+    vector_t_reserve(v, 1000);
+    vector_t_push(v, item);
+    break;
+  case 9:
+    vector_t_shrink_to_fit(v);
+    vector_t_set(v, 0, item);
+    break;
+  case 10:
+    vector_t_compact(v);
+    vector_t_set(v, 0, item);
+    break;
+  case 11:
+    vector_t_move(v, 2, 7);
+    break;
+  case 12:
+    vector_t_swap(v, 2, 9);
+    break;
+  case 13:
+    vector_t_reverse(v);
+    break;
+  case 14:
+    vector_t_clean(v);
+    break;
+  case 15:
+    vector_t_sort(v, vector_t_element_size(v) > 0 ? int_compare : t_test_compare);
+    break;
+  case 16:
+    vector_t_append_vector(v, v);
+    break;
+  default:
+    vector_t_gap_buffer(v, 1);
+    vector_t_insert(v, 4, item);
+  }
+}
+
+static int t_test_odd(const void *item, void *context)
+{
+  int *calls = context;
+
+  (*calls)++;
+
+  return ((const t_test *)item)->id % 2 != 0;
+}
+
+static int int_divisible(const void *item, void *context)
+{
+  return *(const int *)item % *(int *)context == 0;
+}
+
+static char *test_vector_t_remove_if()
+{
+  t_test s[100];
+  int calls = 0;
+
+  for (int i = 0; i < 100; i++)
+    s[i].id = i * 7;
+
+  for (int bitmap = 0; bitmap < 2; bitmap++)
+  {
+    vector_t *v = vector_t_create(120);
+    vector_t *loop = vector_t_create(120);
+
+    vector_t_bitmap(v, bitmap);
+
+    // holes every 3rd position
+    for (size_t i = 0; i < 100; i++)
+    {
+      vector_t_set(v, i, i % 3 == 0 ? NULL : &s[i]);
+      vector_t_set(loop, i, i % 3 == 0 ? NULL : &s[i]);
+    }
+
+    for (size_t i = 0; i < vector_t_length(loop);)
+    {
+      t_test *item = vector_t_get(loop, i);
+
+      if (item != NULL && item->id % 2 != 0)
+        vector_t_remove(loop, i, 1);
+      else
+        i++;
+    }
+
+    calls = 0;
+    expect("vector_t_remove_if count", vector_t_remove_if(v, t_test_odd, &calls) == 33);
+    expect("vector_t_remove_if calls", calls == 66);
+    expect("vector_t_remove_if size", vector_t_size(v) == vector_t_size(loop));
+    expect("vector_t_remove_if length", vector_t_length(v) == vector_t_length(loop));
+    expect("vector_t_remove_if count", vector_t_count(v) == vector_t_count(loop));
+
+    for (size_t i = 0; i < vector_t_size(v); i++)
+      expect("vector_t_remove_if get", vector_t_get(v, i) == vector_t_get(loop, i));
+
+    calls = 0;
+    expect("vector_t_retain count", vector_t_retain(v, t_test_odd, &calls) == 33);
+    expect("vector_t_retain length", vector_t_length(v) == 0);
+
+    vector_t_destroy(loop);
+    vector_t_destroy(v);
+  }
+
+  vector_t *sized = vector_t_create_sized(sizeof(int), 0);
+  int three = 3;
+
+  for (int i = 0; i < 100; i++)
+    vector_t_push(sized, &i);
+
+  expect("vector_t_retain (sized)", vector_t_retain(sized, int_divisible, &three) == 66);
+  expect("vector_t_retain (sized) size", vector_t_size(sized) == 34);
+
+  for (size_t i = 0; i < vector_t_size(sized); i++)
+    expect("vector_t_retain (sized) get", *(int *)vector_t_get(sized, i) == (int)i * 3);
+
+  expect("vector_t_remove_if (sized)", vector_t_remove_if(sized, int_divisible, &three) == 34);
+  expect("vector_t_remove_if (sized) size", vector_t_size(sized) == 0);
+
+  vector_t_destroy(sized);
+
+  return 0;
+}
+
+static int t_test_pointer_odd(const void *item, void *context)
+{
+  return ((uintptr_t)item / sizeof(t_test)) % 2 != 0;
+}
+
+static void vector_t_remove_if_batch(vector_t *v, size_t size)
+{
+  vector_t_remove_if(v, t_test_pointer_odd, NULL);
+}
+
+static char *test_vector_t_remove_if_performance()
+{
+  vector_t *v = vector_t_create(0);
+  t_test *s = malloc_realloc(sizeof(t_test) * 1000000, NULL);
+  int elapsed;
+
+  for (size_t i = 0; i < 1000000; i++)
+    vector_t_push(v, &s[i]);
+
+  elapsed = with_elapsed(v, 0, vector_t_remove_if_batch);
+  expect("vector_t_remove_if_batch < 200ms", elapsed < 200);
+  expect("vector_t_remove_if_batch length", vector_t_length(v) == 500000);
+
+  vector_t_destroy(v);
+  free(s);
+
+  return 0;
+}
+
+static char *test_vector_t_copy_on_write()
+{
+  t_test s[64];
+  int values[64];
+  void *saved[64];
+  int saved_values[64];
+
+  for (int i = 0; i < 64; i++)
+  {
+    s[i].id = 64 - i;
+    values[i] = 64 - i;
+  }
+
+  for (size_t width = 0; width <= sizeof(int); width += sizeof(int))
+  {
+    vector_t *v = vector_t_create_sized(width, 0);
+
+    for (size_t i = 0; i < 64; i++)
+      vector_t_push(v, width > 0 ? (void *)&values[i] : (i % 5 == 1 ? NULL : &s[i]));
+
+    for (int op = 0; op < 18; op++)
+    {
+      for (int target = 0; target < 2; target++)
+      {
+        vector_t *copy = vector_t_copy(v);
+        vector_t *untouched = target == 0 ? v : copy;
+        size_t size = vector_t_size(untouched);
+        int item = 1000;
+
+        for (size_t i = 0; i < size; i++)
+        {
+          if (width > 0)
+            saved_values[i] = *(int *)vector_t_get(untouched, i);
+          else
+            saved[i] = vector_t_get(untouched, i);
+        }
+
+        t_test_mutate(target == 0 ? copy : v, op, width > 0 ? (void *)&item : &s[63]);
+
+        expect("vector_t_copy untouched size", vector_t_size(untouched) == size);
+
+        for (size_t i = 0; i < size; i++)
+        {
+          if (width > 0)
+            expect("vector_t_copy untouched", *(int *)vector_t_get(untouched, i) == saved_values[i]);
+          else
+            expect("vector_t_copy untouched", vector_t_get(untouched, i) == saved[i]);
+        }
+
+        // `v` starts over from the untouched copy
+        if (target == 1)
+        {
+          vector_t_destroy(v);
+          v = vector_t_copy(copy);
+        }
+
+        vector_t_destroy(copy);
+      }
+    }
+
+    vector_t_destroy(v);
+  }
+
+  // copies of copies, released in any order
+  vector_t *v = vector_t_create(100000);
+  vector_t_set(v, 99999, &s[0]);
+
+  vector_t *a = vector_t_copy(v);
+  vector_t *b = vector_t_copy(a);
+  vector_t_destroy(v);
+  vector_t_set(a, 0, &s[1]);
+  vector_t_destroy(b);
+  expect("vector_t_copy (chain)", vector_t_get(a, 0) == &s[1] && vector_t_get(a, 99999) == &s[0]);
+  vector_t_destroy(a);
+
+  matrix_t *m = matrix_t_create(2, 10);
+  matrix_t_set(m, 1, 9, &s[2]);
+  matrix_t *mm = matrix_t_copy(m);
+  matrix_t_set(mm, 1, 9, &s[3]);
+  expect("matrix_t_copy", matrix_t_get(m, 1, 9) == &s[2] && matrix_t_get(mm, 1, 9) == &s[3]);
+  matrix_t_destroy(mm);
+  matrix_t_destroy(m);
+
+  return 0;
+}
+
+static void vector_t_copy_batch(vector_t *v, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    vector_t_destroy(vector_t_copy(v));
+}
+
+static char *test_vector_t_copy_performance()
+{
+  vector_t *v = vector_t_create(10000000);
+  t_test s1 = {42};
+  int elapsed;
+
+  vector_t_set(v, 9999999, &s1);
+
+  elapsed = with_elapsed(v, 1000, vector_t_copy_batch);
+  expect("vector_t_copy_batch < 100ms", elapsed < 100);
+
+  vector_t_destroy(v);
+
+  return 0;
+}
+
+static char *test_vector_t_sort()
+{
+  vector_t *v = vector_t_create(8);
+  t_test s[5] = {{101}, {1}, {42}, {37}, {42}};
+
+  vector_t_set(v, 0, &s[0]);
+  vector_t_set(v, 2, &s[1]);
+  vector_t_set(v, 3, &s[2]);
+  vector_t_set(v, 5, &s[3]);
+  vector_t_set(v, 6, &s[4]);
+
+  vector_t_sort(v, t_test_compare);
+  expect("vector_t_sort size", vector_t_size(v) == 8);
+  expect("vector_t_sort length", vector_t_length(v) == 5);
+  expect("vector_t_get (0) == 1", vector_t_get(v, 0) == &s[1]);
+  expect("vector_t_get (1) == 37", vector_t_get(v, 1) == &s[3]);
+  expect("vector_t_get (2) == 42, stable", vector_t_get(v, 2) == &s[2]);
+  expect("vector_t_get (3) == 42, stable", vector_t_get(v, 3) == &s[4]);
+  expect("vector_t_get (4) == 101", vector_t_get(v, 4) == &s[0]);
+  expect("vector_t_get (5) == NULL", vector_t_get(v, 5) == NULL);
+
+  t_test key = {42};
+  expect("vector_t_lower_bound (42)", vector_t_lower_bound(v, &key, t_test_compare) == 2);
+  expect("vector_t_bsearch (42)", vector_t_bsearch(v, &key, t_test_compare) == &s[2]);
+
+  key.id = 50;
+  expect("vector_t_lower_bound (50)", vector_t_lower_bound(v, &key, t_test_compare) == 4);
+  expect("vector_t_bsearch (50)", vector_t_bsearch(v, &key, t_test_compare) == NULL);
+
+  key.id = 200;
+  expect("vector_t_lower_bound (200)", vector_t_lower_bound(v, &key, t_test_compare) == 5);
+
+  vector_t_destroy(v);
+
+  vector_t *sized = vector_t_create_sized(sizeof(int), 0);
+
+  for (int i = 0; i < 1000; i++)
+  {
+    int n = (i * 7919) % 1000;
+    vector_t_push(sized, &n);
+  }
+
+  vector_t_sort(sized, int_compare);
+
+  for (int i = 0; i < 1000; i++)
+    expect("vector_t_sort sized", *(int *)vector_t_get(sized, i) == i);
+
+  int n = 500;
+  expect("vector_t_bsearch sized", *(int *)vector_t_bsearch(sized, &n, int_compare) == 500);
+
+  vector_t_destroy(sized);
+
+  return 0;
+}
+
+static char *test_vector_t_gap_buffer()
+{
+  t_test s[3] = {{1}, {37}, {42}};
+
+  for (size_t width = 0; width <= sizeof(int); width += sizeof(int))
+  {
+    vector_t *v = vector_t_create_sized(width, 10);
+    vector_t *g = vector_t_create_sized(width, 10);
+    size_t cursor = 5;
+
+    vector_t_gap_buffer(g, 1);
+
+    // same edits around a moving cursor, with and without the gap
+    for (size_t i = 0; i < 2000; i++)
+    {
+      vector_t *t = v;
+      int n = (int)i + 1;
+      void *item = width > 0 ? (void *)&n : (void *)&s[i % 3];
+
+      cursor = (cursor + (i % 7) - 3 + 400) % 400;
+
+      for (int j = 0; j < 2; j++, t = g)
+      {
+        switch (i % 8)
+        {
+        case 0:
+        case 1:
+        case 2:
+          vector_t_insert(t, cursor, item);
+          break;
+        case 3:
+        case 4:
+          vector_t_remove(t, cursor, i % 3 + 1);
+          break;
+        case 5:
+          vector_t_set(t, cursor, i % 2 ? item : NULL);
+          break;
+        case 6:
+          if (i % 64 == 6)
+            vector_t_push(t, item);
+          else
+            vector_t_set(t, cursor / 2, item);
+          break;
+        default:
+          vector_t_remove(t, cursor / 3, 1);
+        }
+      }
+
+      expect("vector_t_gap_buffer size", vector_t_size(v) == vector_t_size(g));
+      expect("vector_t_gap_buffer length", vector_t_length(v) == vector_t_length(g));
+
+      // counted over the gap, without closing it
+      if (i % 50 == 0)
+      {
+        expect("vector_t_gap_buffer count", vector_t_count(v) == vector_t_count(g));
+        expect("vector_t_gap_buffer first_free", vector_t_first_free(v) == vector_t_first_free(g));
+      }
+    }
+
+    for (size_t i = 0; i < vector_t_size(v); i++)
+    {
+      if (width > 0)
+        expect("vector_t_gap_buffer get", *(int *)vector_t_get(v, i) == *(int *)vector_t_get(g, i));
+      else
+        expect("vector_t_gap_buffer get", vector_t_get(v, i) == vector_t_get(g, i));
+    }
+
+    expect("vector_t_gap_buffer count", vector_t_count(v) == vector_t_count(g));
+
+    vector_t_destroy(g);
+    vector_t_destroy(v);
+  }
+
+  return 0;
+}
+
+static void vector_t_insert_batch(vector_t *v, size_t size)
+{
+  t_test s1 = {100000000};
+
+  for (int i = 0; i < size; i++)
+  {
+    vector_t_insert(v, i, &s1);
+  }
+}
+
+static void vector_t_push_batch(vector_t *v, size_t size)
+{
+  t_test s1 = {100000000};
+
+  for (int i = 0; i < size; i++)
+  {
+    vector_t_push(v, &s1);
+  }
+}
+
+static void vector_t_remove_batch(vector_t *v, size_t size)
+{
+  vector_t_remove(v, 0, size);
+}
+
+static char *test_vector_t_performance()
+{
+  vector_t *v = vector_t_create(1000000);
+  int elapsed;
+
+  elapsed = with_elapsed(v, 1000000, vector_t_insert_batch);
+  expect("vector_t_insert_batch < 10ms", elapsed < 10);
+  expect("vector_t_insert_batch size", vector_t_size(v) == 1000000);
+
+  elapsed = with_elapsed(v, 100000, vector_t_push_batch);
+  expect("vector_t_push_batch < 50ms", elapsed < 50);
+  expect("vector_t_push_batch size", vector_t_size(v) == 1100000);
+
+  elapsed = with_elapsed(v, 100000, vector_t_remove_batch);
+  expect("vector_t_remove_batch < 50ms", elapsed < 50);
+  expect("vector_t_remove_batch size", vector_t_size(v) == 1100000);
+  expect("vector_t_remove_batch compact", vector_t_compact(v) == 1000000);
+
+  vector_t_destroy(v);
+
+  v = vector_t_create(0);
+
+  elapsed = with_elapsed(v, 10000000, vector_t_push_batch);
+  expect("vector_t_push_batch (empty) < 200ms", elapsed < 200);
+  expect("vector_t_push_batch (empty) size", vector_t_size(v) == 10000000);
+
+  vector_t_destroy(v);
+
+#ifdef TEST_LARGE
+  // 100M members take about 1GB, built with `make large`
+  v = vector_t_create(0);
+
+  elapsed = with_elapsed(v, 100000000, vector_t_push_batch);
+  expect("vector_t_push_batch (100M) < 2000ms", elapsed < 2000);
+  expect("vector_t_push_batch (100M) length", vector_t_length(v) == 100000000);
+  expect("vector_t_push_batch (100M) capacity", vector_t_capacity(v) < 2 * 100000000);
+
+  vector_t_destroy(v);
+#endif
+
+  return 0;
+}
+
+static void t_test_sum_int(const int *item, void *context)
+{
+  *(int *)context += *item;
+}
+
+static void int_vector_insert_batch(int_vector_t *v, size_t size)
+{
+  for (int i = 0; i < size; i++)
+  {
+    int_vector_insert(v, i, 100000000);
+  }
+}
+
+static void int_vector_push_batch(int_vector_t *v, size_t size)
+{
+  for (int i = 0; i < size; i++)
+  {
+    int_vector_push(v, 100000000);
+  }
+}
+
+static void int_vector_remove_batch(int_vector_t *v, size_t size)
+{
+  int_vector_remove(v, 0, size);
+}
+
+static char *test_vector_type()
+{
+  int_vector_t *v = int_vector_create(3);
+
+  expect("int_vector_size (3)", int_vector_size(v) == 3);
+  expect("int_vector_get (0) == 0", int_vector_get(v, 0) == 0);
+
+  int_vector_set(v, 0, 1);
+  int_vector_set(v, 5, 42);
+  expect("int_vector_set size", int_vector_size(v) == 6);
+  expect("int_vector_get (5) == 42", int_vector_get(v, 5) == 42);
+  expect("int_vector_get (4) == 0", int_vector_get(v, 4) == 0);
+
+  int_vector_insert(v, 0, 37);
+  expect("int_vector_insert size", int_vector_size(v) == 7);
+  expect("int_vector_get (0) == 37", int_vector_get(v, 0) == 37);
+  expect("int_vector_get (1) == 1", int_vector_get(v, 1) == 1);
+
+  int_vector_push(v, 101);
+  expect("int_vector_push", int_vector_get(v, 7) == 101);
+
+  int_vector_remove(v, 1, 6);
+  expect("int_vector_remove size", int_vector_size(v) == 2);
+  expect("int_vector_get (0) == 37", int_vector_get(v, 0) == 37);
+  expect("int_vector_get (1) == 101", int_vector_get(v, 1) == 101);
+
+  int sum = 0;
+  int_vector_for_each(v, t_test_sum_int, &sum);
+  expect("int_vector_for_each", sum == 37 + 101);
+
+  expect("int_vector_reserve (overflow)", int_vector_reserve(v, SIZE_MAX / 2) == -1 && int_vector_size(v) == 2);
+  int_vector_set(v, SIZE_MAX / 2, 1);
+  expect("int_vector_set (overflow)", int_vector_size(v) == 2);
+  expect("int_vector_create (overflow)", int_vector_create(SIZE_MAX / 2) == NULL);
+
+  int_vector_destroy(v);
+
+  return 0;
+}
+
+static char *test_vector_type_performance()
+{
+  vector_t *v = vector_t_create(0);
+  int_vector_t *iv = int_vector_create(0);
+  int elapsed, typed;
+
+  elapsed = with_elapsed(v, 1000000, vector_t_insert_batch);
+  typed = with_elapsed_int_vector(iv, 1000000, int_vector_insert_batch);
+  report("int_vector_insert_batch", typed, "vector_t_insert_batch", elapsed);
+  expect("int_vector_insert_batch size", int_vector_size(iv) == 1000000);
+
+  elapsed = with_elapsed(v, 1000000, vector_t_push_batch);
+  typed = with_elapsed_int_vector(iv, 1000000, int_vector_push_batch);
+  report("int_vector_push_batch", typed, "vector_t_push_batch", elapsed);
+  expect("int_vector_push_batch size", int_vector_size(iv) == 2000000);
+
+  elapsed = with_elapsed(v, 100000, vector_t_remove_batch);
+  typed = with_elapsed_int_vector(iv, 100000, int_vector_remove_batch);
+  report("int_vector_remove_batch", typed, "vector_t_remove_batch", elapsed);
+  expect("int_vector_remove_batch size", int_vector_size(iv) == 1900000);
+
+  int_vector_destroy(iv);
+  vector_t_destroy(v);
+
+  return 0;
+}
+
+static void vector_t_compact_batch(vector_t *v, size_t size)
+{
+  vector_t_compact(v);
+}
+
+static char *test_vector_t_compact_performance()
+{
+  vector_t *v = vector_t_create(10000000);
+  t_test s1 = {42};
+  int elapsed;
+
+  size_t count = 0;
+
+  // scattered members, no pattern for the branch predictor
+  for (size_t i = 0; i < 10000000; i++)
+  {
+    if (((i * 2654435761u) >> 13) & 1)
+    {
+      vector_t_set(v, i, &s1);
+      count++;
+    }
+  }
+
+  elapsed = with_elapsed(v, 10000000, vector_t_compact_batch);
+  expect("vector_t_compact_batch < 60ms", elapsed < 60);
+  expect("vector_t_compact_batch length", vector_t_length(v) == count);
+  expect("vector_t_compact_batch count", vector_t_count(v) == count);
+
+  vector_t_destroy(v);
+
+  return 0;
+}
+
+static void vector_t_sort_batch(vector_t *v, size_t size)
+{
+  vector_t_sort(v, t_test_compare);
+}
+
+static char *test_vector_t_sort_performance()
+{
+  vector_t *v = vector_t_create(1000000);
+  t_test *s = malloc(sizeof(*s) * 1000000);
+  int elapsed;
+
+  for (size_t i = 0; i < 1000000; i++)
+  {
+    s[i].id = (int)((i * 2654435761u) % 1000000);
+    vector_t_set(v, i, &s[i]);
+  }
+
+  elapsed = with_elapsed(v, 1000000, vector_t_sort_batch);
+  expect("vector_t_sort_batch < 5000ms", elapsed < 5000);
+
+  for (size_t i = 1; i < 1000000; i++)
+    expect("vector_t_sort_batch order", t_test_compare(vector_t_get(v, i - 1), vector_t_get(v, i)) <= 0);
+
+  vector_t_destroy(v);
+  free(s);
+
+  return 0;
+}
+
+static char *test_vector_t_iterator()
+{
+  vector_t *v = vector_t_create(1000000);
+  vector_t_insert_batch(v, 1000000);
+
+  vector_t_iterator *i = vector_t_iterator_create(v);
+  void *t = NULL;
+
+  while ((t = vector_t_iterator_next(i)) != NULL)
+  {
+    expect("vector_t_iterator_next < 1000000", vector_t_iterator_cursor(i) < 1000000);
+  }
+
+  vector_t_iterator_reset(i);
+  expect("vector_t_iterator_reset", vector_t_iterator_cursor(i) == 0);
+
+  vector_t_destroy(v);
+  vector_t_iterator_destroy(i);
+
+  return 0;
+}
+
+static void t_test_sum(void *item, const size_t index, void *context)
+{
+  *(size_t *)context += ((t_test *)item)->id + index;
+}
+
+static char *test_vector_t_iterator_init()
+{
+  vector_t *v = vector_t_create(6);
+  t_test s[3] = {{1}, {37}, {42}};
+
+  vector_t_set(v, 1, &s[0]);
+  vector_t_set(v, 3, &s[1]);
+  vector_t_set(v, 4, &s[2]);
+
+  vector_t_iterator iter;
+  size_t visited = 0;
+  size_t found = 0;
+
+  vector_t_iterator_init(&iter, v);
+
+  // holes do not stop the loop
+  while (vector_t_iterator_has_next(&iter))
+  {
+    if (vector_t_iterator_next(&iter) != NULL)
+      found++;
+
+    visited++;
+  }
+
+  expect("vector_t_iterator_init visited", visited == 6);
+  expect("vector_t_iterator_init found", found == 3);
+  expect("vector_t_iterator_next end", vector_t_iterator_next(&iter) == NULL);
+
+  vector_t_iterator_init_range(&iter, v, 3, 5);
+  expect("vector_t_iterator_init_range (3)", vector_t_iterator_next(&iter) == &s[1]);
+  expect("vector_t_iterator_cursor (3)", vector_t_iterator_cursor(&iter) == 3);
+  expect("vector_t_iterator_init_range (4)", vector_t_iterator_next(&iter) == &s[2]);
+  expect("vector_t_iterator_init_range end", !vector_t_iterator_has_next(&iter));
+
+  vector_t_iterator_init_reverse(&iter, v);
+  expect("vector_t_iterator_init_reverse (5)", vector_t_iterator_next(&iter) == NULL);
+  expect("vector_t_iterator_cursor (5)", vector_t_iterator_cursor(&iter) == 5);
+  expect("vector_t_iterator_init_reverse (4)", vector_t_iterator_next(&iter) == &s[2]);
+  expect("vector_t_iterator_init_reverse (3)", vector_t_iterator_next(&iter) == &s[1]);
+
+  visited = 3;
+  while (vector_t_iterator_has_next(&iter))
+  {
+    vector_t_iterator_next(&iter);
+    visited++;
+  }
+
+  expect("vector_t_iterator_init_reverse visited", visited == 6);
+  expect("vector_t_iterator_cursor (0)", vector_t_iterator_cursor(&iter) == 0);
+
+  vector_t_iterator_reset(&iter);
+  expect("vector_t_iterator_reset reverse", vector_t_iterator_next(&iter) == NULL);
+  expect("vector_t_iterator_reset reverse (4)", vector_t_iterator_next(&iter) == &s[2]);
+
+  size_t sum = 0;
+  vector_t_for_each(v, t_test_sum, &sum);
+  expect("vector_t_for_each", sum == 1 + 1 + 37 + 3 + 42 + 4);
+
+  sum = 0;
+  vector_t_for_each_prefetch(v, t_test_sum, &sum, 2);
+  expect("vector_t_for_each_prefetch", sum == 1 + 1 + 37 + 3 + 42 + 4);
+
+  vector_t_destroy(v);
+
+  return 0;
+}
+
+static char *test_matrix_t()
+{
+  matrix_t *m = matrix_t_create(2, 3);
+
+  expect("matrix_t_cols", matrix_t_cols(m) == 3);
+  expect("matrix_t_rows", matrix_t_rows(m) == 2);
+
+  int s[20] = {1, 2, 3, 4, 5, 6};
+
+  for (size_t i = 0; i < matrix_t_rows(m); i++)
+    for (size_t j = 0; j < matrix_t_cols(m); j++)
+      matrix_t_set(m, i, j, &s[i * matrix_t_cols(m) + j]);
+
+  for (size_t i = 0; i < matrix_t_rows(m); i++)
+    for (size_t j = 0; j < matrix_t_cols(m); j++)
+      expect("matrix_t_set", (*(int *)matrix_t_get(m, i, j)) == s[matrix_t_idx(m, i, j)]);
+
+  matrix_t_remove(m, 0, 0);
+  expect("matrix_t_remove", matrix_t_get(m, 1, 2) == NULL);
+
+  matrix_t_resize(m, 3, 4);
+
+  expect("matrix_t_cols", matrix_t_cols(m) == 4);
+  expect("matrix_t_rows", matrix_t_rows(m) == 3);
+
+  matrix_t_remove_row(m, 1);
+
+  for (size_t i = 0; i < matrix_t_cols(m); i++)
+    expect("matrix_t_remove_row", matrix_t_get(m, matrix_t_rows(m) - 1, i) == NULL);
+
+  expect("matrix_t_col", matrix_t_col(m, 2) == 2);
+  expect("matrix_t_row", matrix_t_row(m, 2) == 0);
+
+  expect("matrix_t_col", matrix_t_col(m, 9) == 1);
+  expect("matrix_t_row", matrix_t_row(m, 9) == 2);
+
+  matrix_t_destroy(m);
+
+  return 0;
+}
+
+static char *test_node_t()
+{
+  int s[4] = {1, 37, 42, 101};
+
+  node_t *head = node_t_create(&s[2], NULL);
+  node_t *tail = NULL;
+  node_t *iter = NULL;
+
+  expect("node_t_peek", (*(int *)node_t_peek(head)) == s[2]);
+  expect("node_t_peek", (*(int *)node_t_peek(head)) == s[2]);
+
+  node_t_unshift(&s[1], &head);
+  expect("node_t_unshift", (*(int *)node_t_peek(head)) == s[1]);
+
+  expect("node_t_shift", (*(int *)node_t_shift(&head)) == s[1]);
+  expect("node_t_shift", (*(int *)node_t_peek(head)) == s[2]);
+
+  node_t_unshift(&s[1], &head);
+  expect("node_t_unshift", (*(int *)node_t_peek(head)) == s[1]);
+
+  node_t_unshift(&s[0], &head);
+  expect("node_t_unshift", (*(int *)node_t_peek(head)) == s[0]);
+
+  tail = node_t_push(&s[3], &head);
+  expect("node_t_push", (*(int *)node_t_peek(head)) == s[0]);
+  expect("node_t_push", (*(int *)node_t_peek(tail)) == s[3]);
+
+  iter = head;
+  for (size_t i = 0; i < sizeof(s) / sizeof(s[0]); i++)
+  {
+    expect("iter", (*(int *)node_t_peek(iter)) == s[i]);
+    iter = node_t_next(iter); 
+  }
+
+  expect("node_t_size", node_t_size(head) == 4);
+  expect("node_t_size", node_t_size(head) == 4);
+
+  node_t_destroy(head);
+  return 0;
+}
+
+typedef struct
+{
+  size_t allocated;
+  size_t freed;
+  size_t live;
+  int failing; // allocations return NULL while set
+} t_test_counts;
+
+static void *t_test_alloc(size_t size, void *context)
+{
+  t_test_counts *counts = context;
+
+  if (counts->failing)
+    return NULL;
+
+  counts->allocated++;
+  counts->live += size;
+  return malloc_realloc(size, NULL);
+}
+
+static void *t_test_realloc(void *data, size_t old_size, size_t size, void *context)
+{
+  t_test_counts *counts = context;
+
+  if (counts->failing)
+    return NULL;
+
+  if (data == NULL)
+    counts->allocated++;
+
+  counts->live += size - old_size;
+  return malloc_realloc(size, data);
+}
+
+static void t_test_free(void *data, size_t size, void *context)
+{
+  t_test_counts *counts = context;
+  counts->freed++;
+  counts->live -= size;
+  heap_free(data);
+}
+
+static char *test_list_t()
+{
+  int s[6] = {1, 37, 42, 101, 7, 9};
+  list_t *l = list_t_create();
+
+  expect("list_t_size empty", list_t_size(l) == 0);
+  expect("list_t_shift empty", list_t_shift(l) == NULL);
+
+  list_t_push(l, &s[2]);
+  expect("list_t_push", list_t_head(l) == list_t_tail(l));
+
+  list_t_push(l, &s[3]);
+  list_t_unshift(l, &s[1]);
+  list_t_unshift(l, &s[0]);
+
+  expect("list_t_size", list_t_size(l) == 4);
+  expect("list_t_head", node_t_peek(list_t_head(l)) == &s[0]);
+  expect("list_t_tail", node_t_peek(list_t_tail(l)) == &s[3]);
+
+  node_t *iter = list_t_head(l);
+  for (size_t i = 0; i < 4; i++, iter = node_t_next(iter))
+    expect("list_t iter", node_t_peek(iter) == &s[i]);
+
+  expect("list_t_shift", list_t_shift(l) == &s[0]);
+  expect("list_t_size", list_t_size(l) == 3);
+
+  list_t *other = list_t_create();
+  list_t_push(other, &s[4]);
+  list_t_push(other, &s[5]);
+
+  // 37 -> 7 -> 9 -> 42 -> 101
+  list_t_splice(l, list_t_head(l), other);
+  expect("list_t_splice size", list_t_size(l) == 5 && list_t_size(other) == 0);
+  expect("list_t_splice other", list_t_head(other) == NULL && list_t_tail(other) == NULL);
+  expect("list_t_splice order", node_t_peek(node_t_next(list_t_head(l))) == &s[4]);
+  expect("list_t_splice tail", node_t_peek(list_t_tail(l)) == &s[3]);
+
+  // 0 -> 37 -> 7 -> 9 -> 42 -> 101 -> 1
+  list_t_unshift(other, &s[0]);
+  list_t_splice(l, NULL, other);
+  expect("list_t_splice front", node_t_peek(list_t_head(l)) == &s[0]);
+
+  list_t_push(other, &s[0]);
+  list_t_concat(l, other);
+  expect("list_t_concat size", list_t_size(l) == 7 && list_t_size(other) == 0);
+  expect("list_t_concat tail", node_t_peek(list_t_tail(l)) == &s[0]);
+  expect("list_t_size walk", node_t_size(list_t_head(l)) == 7);
+
+  list_t_push(other, &s[1]);
+  list_t_concat(other, l);
+  expect("list_t_concat into", list_t_size(other) == 8 && list_t_size(l) == 0);
+  expect("list_t_concat into", node_t_peek(list_t_head(other)) == &s[1]);
+
+  while (list_t_size(other) > 0)
+    list_t_shift(other);
+
+  expect("list_t_shift all", list_t_head(other) == NULL && list_t_tail(other) == NULL);
+  list_t_push(other, &s[2]);
+  expect("list_t_push after shift", list_t_head(other) == list_t_tail(other));
+
+  list_t_destroy(other);
+  list_t_destroy(l);
+
+  return 0;
+}
+
+static void list_t_push_batch(list_t *l, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    list_t_push(l, l);
+}
+
+static char *test_list_t_performance()
+{
+  list_t *l = list_t_create_with_allocator(node_t_allocator());
+  int elapsed;
+
+  elapsed = with_elapsed_list(l, 1000000, list_t_push_batch);
+  expect("list_t_push_batch < 1000ms", elapsed < 1000);
+  expect("list_t_push_batch size", list_t_size(l) == 1000000);
+
+  list_t_destroy(l);
+
+  return 0;
+}
+
+static char *test_vector_t_stats()
+{
+  vector_t_stats_t before, after;
+  int s[100];
+
+  vector_t_stats(&before);
+
+  vector_t *v = vector_t_create(0);
+
+  for (size_t i = 0; i < 100; i++)
+    vector_t_push(v, &s[i]);
+
+  vector_t_insert(v, 0, &s[0]);
+  vector_t_remove(v, 0, 1);
+  vector_t_set(v, 50, NULL);
+  vector_t_compact(v);
+  vector_t_resize(v, 10);
+  vector_t_destroy(v);
+
+  vector_t_stats(&after);
+
+#ifdef VECTOR_STATS
+  expect("vector_t_stats resizes", after.resizes - before.resizes == 1);
+  expect("vector_t_stats grows", after.grows - before.grows == 6);
+  expect("vector_t_stats pushes", after.pushes - before.pushes == 100);
+  expect("vector_t_stats moved", after.moved - before.moved == 2 * 100 * sizeof(void *));
+  expect("vector_t_stats scanned", after.scanned - before.scanned >= 100);
+#else
+  expect("vector_t_stats disabled", after.resizes == 0 && after.moved == 0 && after.scanned == 0);
+#endif
+
+  return 0;
+}
+
+static char *test_node_t_stats()
+{
+  node_t_stats_t before, after;
+  int s[10];
+
+  node_t_stats(&before);
+
+  node_t *head = NULL;
+
+  for (size_t i = 0; i < 10; i++)
+    node_t_push(&s[i], &head);
+
+  node_t_size(head);
+  node_t_destroy(head);
+
+  node_t_stats(&after);
+
+#ifdef NODE_STATS
+  expect("node_t_stats walked", after.walked - before.walked == 45 + 10);
+#else
+  expect("node_t_stats disabled", after.walked == 0);
+#endif
+
+  return 0;
+}
+
+static char *test_heap_stats()
+{
+  heap_stats_t before, after;
+  heap_stats(&before);
+
+  vector_t *v = vector_t_create(0);
+
+  for (size_t i = 0; i < 1000; i++)
+    vector_t_push(v, &before);
+
+  vector_t_destroy(v);
+
+  int_vector_t *typed = int_vector_create(1000);
+  int_vector_destroy(typed);
+
+  heap_stats(&after);
+
+#ifdef HEAP_STATS
+  expect("heap_stats allocations", after.allocations > before.allocations);
+  expect("heap_stats reallocations", after.reallocations > before.reallocations);
+  expect("heap_stats frees", after.frees - before.frees == after.allocations - before.allocations);
+  expect("heap_stats live", after.live == before.live);
+  expect("heap_stats peak", after.peak >= before.live + 1000 * sizeof(void *));
+  expect("heap_stats classes", after.classes[13] > before.classes[13]);
+#else
+  expect("heap_stats disabled", after.allocations == 0 && after.live == 0 && after.classes[13] == 0);
+#endif
+
+  return 0;
+}
+
+static char *test_allocator()
+{
+  t_test_counts counts = {0, 0, 0, 0};
+  allocator_t allocator = {t_test_alloc, t_test_realloc, t_test_free, &counts};
+  int s[100];
+
+  vector_t *v = vector_t_create_with_allocator(0, &allocator);
+  expect("vector_t_create_with_allocator", counts.allocated == 1);
+
+  for (size_t i = 0; i < 100; i++)
+    vector_t_push(v, &s[i]);
+
+  vector_t_bitmap(v, 1);
+  vector_t *copy = vector_t_copy(v);
+  vector_t_set(copy, 0, NULL);
+
+  expect("vector_t_copy allocator", vector_t_get(v, 0) == &s[0]);
+  expect("vector_t_copy allocator", counts.allocated > 4);
+
+  // a copy that can not take its own buffer is left as is, still sharing it
+  vector_t *failed = vector_t_copy(v);
+  counts.failing = 1;
+  vector_t_set(failed, 1, NULL);
+  vector_t_push(failed, &s[1]);
+  expect("vector_t_set (unshare failure)", vector_t_get(failed, 1) == &s[1] && vector_t_size(failed) == 100);
+  expect("vector_t_align (unshare failure)", vector_t_align(failed, 64) == -1);
+  counts.failing = 0;
+  vector_t_set(failed, 1, NULL);
+  expect("vector_t_set (unshared)", vector_t_get(failed, 1) == NULL && vector_t_get(v, 1) == &s[1]);
+  vector_t_destroy(failed);
+
+  vector_t_align(copy, 64);
+  vector_t_push(copy, &s[0]);
+  vector_t_shrink_to_fit(v);
+  vector_t_destroy(copy);
+  vector_t_destroy(v);
+
+  vector_t *sized = vector_t_create_sized_with_allocator(sizeof(int), 100, &allocator);
+  size_t allocated = counts.allocated, live = counts.live;
+  vector_t_sort(sized, int_compare);
+  expect("vector_t_sort (allocator)", counts.allocated > allocated && counts.live == live);
+  vector_t_destroy(sized);
+
+  allocated = counts.allocated;
+  matrix_t *ms = matrix_t_create_sized_with_allocator(sizeof(int), 10, 10, &allocator);
+  expect("matrix_t_create_sized_with_allocator", ms != NULL && counts.allocated > allocated);
+  matrix_t_destroy(ms);
+
+  matrix_t *m = matrix_t_create_with_allocator(10, 10, &allocator);
+  matrix_t *mc = matrix_t_copy(m);
+  matrix_t_set(mc, 0, 0, &s[0]);
+  matrix_t_destroy(m);
+  matrix_t_destroy(mc);
+
+  node_t *head = node_t_create_with_allocator(&s[0], NULL, &allocator);
+
+  for (size_t i = 1; i < 10; i++)
+    node_t_push_with_allocator(&s[i], &head, &allocator);
+
+  node_t_unshift_with_allocator(&s[10], &head, &allocator);
+  expect("node_t_shift_with_allocator", node_t_shift_with_allocator(&head, &allocator) == &s[10]);
+  expect("node_t_size", node_t_size(head) == 10);
+  node_t_destroy_with_allocator(head, &allocator);
+
+  expect("allocator frees all", counts.allocated == counts.freed);
+  expect("allocator sizes", counts.live == 0);
+
+  return 0;
+}
+
+static char *test_arena()
+{
+  arena_t *a = arena_create(256);
+  const allocator_t *allocator = arena_allocator(a);
+  int s[100];
+
+  char *first = arena_alloc(a, 1);
+  char *second = arena_alloc(a, 1);
+  expect("arena_alloc aligned", (uintptr_t)first % _Alignof(max_align_t) == 0);
+  expect("arena_alloc aligned", second - first == _Alignof(max_align_t));
+  expect("arena_alloc (too large)", arena_alloc(a, SIZE_MAX - 8) == NULL && arena_alloc(a, SIZE_MAX / 2) == NULL);
+
+  // the latest allocation is resized and given back in place
+  expect("arena realloc in place", allocator->realloc(second, 1, 64, allocator->context) == second);
+  allocator->free(second, 64, allocator->context);
+  expect("arena free last", arena_alloc(a, 8) == second);
+
+  char *large = arena_alloc(a, 4096);
+  memset(large, 1, 4096);
+  expect("arena_alloc large keeps block", arena_alloc(a, 8) == second + _Alignof(max_align_t));
+
+  vector_t *v = vector_t_create_with_allocator(0, allocator);
+  node_t *head = NULL;
+
+  for (size_t i = 0; i < 100; i++)
+  {
+    vector_t_push(v, &s[i]);
+    node_t_push_with_allocator(&s[i], &head, allocator);
+  }
+
+  expect("arena vector", vector_t_size(v) == 100 && vector_t_get(v, 99) == &s[99]);
+  expect("arena node", node_t_size(head) == 100 && node_t_peek(head) == &s[0]);
+
+  vector_t_destroy(v);
+  arena_reset(a);
+
+  // after a reset the kept block serves again from its start
+  char *reused = arena_alloc(a, 1);
+  arena_reset(a);
+  expect("arena_reset", arena_alloc(a, 1) == reused);
+
+  vector_t *w = vector_t_create_sized_with_allocator(sizeof(int), 1000, allocator);
+  expect("arena after reset", vector_t_size(w) == 1000);
+
+  arena_destroy(a);
+
+  return 0;
+}
+
+static void arena_list_batch(arena_t *a, size_t size)
+{
+  const allocator_t *allocator = arena_allocator(a);
+  node_t *head = NULL;
+
+  for (size_t i = 0; i < size; i++)
+    node_t_unshift_with_allocator(&head, &head, allocator);
+
+  arena_reset(a);
+}
+
+static void heap_list_batch(arena_t *a, size_t size)
+{
+  node_t *head = NULL;
+
+  for (size_t i = 0; i < size; i++)
+    node_t_unshift(&head, &head);
+
+  node_t_destroy(head);
+}
+
+static char *test_arena_performance()
+{
+  arena_t *a = arena_create(0);
+  int arena, heap;
+
+  // warms up the kept block
+  arena_list_batch(a, 1000);
+
+  arena = with_elapsed_arena(a, 2000000, arena_list_batch);
+  heap = with_elapsed_arena(a, 2000000, heap_list_batch);
+  report("arena_list_batch", arena, "heap_list_batch", heap);
+
+  arena_destroy(a);
+
+  return 0;
+}
+
+#define POOL_TEST_THREADS 4
+
+static void *pool_churn(void *arg)
+{
+  pool_t *p = arg;
+  void *held[100];
+
+  for (size_t round = 0; round < 1000; round++)
+  {
+    for (size_t i = 0; i < 100; i++)
+    {
+      held[i] = pool_alloc(p);
+      *(size_t *)held[i] = i;
+    }
+
+    for (size_t i = 0; i < 100; i++)
+      if (*(size_t *)held[i] != i)
+        return arg;
+
+    for (size_t i = 0; i < 100; i++)
+      pool_free(p, held[i]);
+  }
+
+  return NULL;
+}
+
+static void *pool_hold_one(void *arg)
+{
+  pool_t *p = arg;
+  void *data = pool_alloc(p);
+
+  pool_free(p, data);
+
+  return data;
+}
+
+static char *test_pool()
+{
+  pool_t *p = pool_create(12);
+  const allocator_t *allocator = pool_allocator(p);
+
+  char *a = pool_alloc(p);
+  char *b = pool_alloc(p);
+  expect("pool_alloc distinct", a != b);
+  expect("pool_alloc aligned", (uintptr_t)a % _Alignof(max_align_t) == 0 && (uintptr_t)b % _Alignof(max_align_t) == 0);
+
+  pool_free(p, b);
+  expect("pool_free reuses", pool_alloc(p) == b);
+
+  // blocks past the object size come from the heap
+  char *large = allocator->alloc(64, allocator->context);
+  memset(large, 1, 64);
+  large = allocator->realloc(large, 64, 8, allocator->context);
+  expect("pool_allocator realloc", large[7] == 1);
+  allocator->free(large, 8, allocator->context);
+
+  pthread_t threads[POOL_TEST_THREADS];
+  void *failed = NULL;
+
+  for (size_t i = 0; i < POOL_TEST_THREADS; i++)
+    pthread_create(&threads[i], NULL, pool_churn, p);
+
+  for (size_t i = 0; i < POOL_TEST_THREADS; i++)
+  {
+    void *result = NULL;
+    pthread_join(threads[i], &result);
+    failed = failed != NULL ? failed : result;
+  }
+
+  expect("pool threads", failed == NULL);
+
+  // objects cached by an exiting thread go back to the pool
+  pool_t *exited = pool_create(sizeof(size_t));
+  void *held = NULL, *found[HEAP_POOL_MAGAZINE];
+  int returned = 0;
+
+  pthread_create(&threads[0], NULL, pool_hold_one, exited);
+  pthread_join(threads[0], &held);
+
+  for (size_t i = 0; i < HEAP_POOL_MAGAZINE; i++)
+  {
+    found[i] = pool_alloc(exited);
+    returned = returned || found[i] == held;
+  }
+
+  expect("pool thread exit", returned);
+
+  for (size_t i = 0; i < HEAP_POOL_MAGAZINE; i++)
+    pool_free(exited, found[i]);
+
+  pool_destroy(exited);
+
+  pool_destroy(p);
+
+  // a new pool may take the slot of the destroyed one, its stale magazine is not reused
+  pool_t *q = pool_create(sizeof(size_t));
+  size_t *c = pool_alloc(q);
+  *c = 1;
+  pool_free(q, c);
+  pool_destroy(q);
+
+  const allocator_t *nodes = node_t_allocator();
+  node_t *head = NULL;
+  int s[10];
+
+  for (size_t i = 0; i < 10; i++)
+    node_t_push_with_allocator(&s[i], &head, nodes);
+
+  expect("node_t_allocator", node_t_size(head) == 10 && node_t_peek(head) == &s[0]);
+  expect("node_t_allocator", node_t_shift_with_allocator(&head, nodes) == &s[0]);
+  node_t_destroy_with_allocator(head, nodes);
+
+  return 0;
+}
+
+static void node_t_churn_batch(const allocator_t *allocator, size_t size)
+{
+  node_t *head = NULL;
+
+  for (size_t i = 0; i < 100; i++)
+    node_t_unshift_with_allocator(&head, &head, allocator);
+
+  for (size_t i = 0; i < size / 2; i++)
+  {
+    node_t_unshift_with_allocator(&head, &head, allocator);
+    node_t_shift_with_allocator(&head, allocator);
+  }
+
+  node_t_destroy_with_allocator(head, allocator);
+}
+
+static char *test_pool_performance()
+{
+  int pool = with_elapsed_node(node_t_allocator(), 10000000, node_t_churn_batch);
+  int heap = with_elapsed_node(&heap_allocator, 10000000, node_t_churn_batch);
+
+  report("node_t_churn_batch pool", pool, "malloc", heap);
+
+  return 0;
+}
+
+static char *test_deque_t()
+{
+  deque_t *d = deque_t_create(5);
+  int s[4] = {1, 37, 42, 101};
+
+  expect("deque_t_create", deque_t_size(d) == 0);
+  expect("deque_t_capacity", deque_t_capacity(d) == 8);
+  expect("deque_t_pop_front (empty)", deque_t_pop_front(d) == NULL);
+  expect("deque_t_pop_back (empty)", deque_t_pop_back(d) == NULL);
+
+  // 37, 42, 101, 1
+  deque_t_push_back(d, &s[2]);
+  deque_t_push_front(d, &s[1]);
+  deque_t_push_back(d, &s[3]);
+  deque_t_push_back(d, &s[0]);
+
+  expect("deque_t_size", deque_t_size(d) == 4);
+  expect("deque_t_get", deque_t_get(d, 0) == &s[1]);
+  expect("deque_t_get", deque_t_get(d, 3) == &s[0]);
+  expect("deque_t_get (out of bounds)", deque_t_get(d, 4) == NULL);
+
+  deque_t_set(d, 1, &s[0]);
+  expect("deque_t_set", deque_t_get(d, 1) == &s[0]);
+
+  expect("deque_t_pop_front", deque_t_pop_front(d) == &s[1]);
+  expect("deque_t_pop_back", deque_t_pop_back(d) == &s[0]);
+  expect("deque_t_size", deque_t_size(d) == 2);
+
+  deque_t_clean(d);
+  expect("deque_t_clean", deque_t_size(d) == 0 && deque_t_capacity(d) == 8);
+
+  // mirrors a window of `model`, growing while wrapped at either end
+  static int model[1 << 12];
+  size_t front = 1 << 11, back = 1 << 11;
+
+  for (size_t i = 0; i < 3000; i++)
+  {
+    int *item = &model[0] + (i % 97);
+
+    switch (i % 5)
+    {
+    case 0:
+    case 1:
+      deque_t_push_back(d, item);
+      model[back++] = (int)(item - model);
+      break;
+    case 2:
+      deque_t_push_front(d, item);
+      model[--front] = (int)(item - model);
+      break;
+    case 3:
+      if (front < back && i % 3 == 0)
+        expect("deque_t_pop_front", deque_t_pop_front(d) == &model[0] + model[front++]);
+      break;
+    default:
+      if (front < back && i % 2 == 0)
+        expect("deque_t_pop_back", deque_t_pop_back(d) == &model[0] + model[--back]);
+    }
+  }
+
+  expect("deque_t_size", deque_t_size(d) == back - front);
+
+  for (size_t i = 0; i < back - front; i++)
+    expect("deque_t_get", deque_t_get(d, i) == &model[0] + model[front + i]);
+
+  deque_t_destroy(d);
+
+  return 0;
+}
+
+static void deque_t_queue_batch(deque_t *d, size_t s)
+{
+  int i = 42;
+
+  // keeps a few members queued, as a producer slightly ahead of its consumer
+  for (size_t k = 0; k < s; k++)
+  {
+    deque_t_push_back(d, &i);
+
+    if (k % 4 != 0)
+      deque_t_pop_front(d);
+  }
+}
+
+static char *test_deque_t_performance()
+{
+  deque_t *d = deque_t_create(0);
+  int elapsed;
+
+  elapsed = with_elapsed_deque(d, 10000000, deque_t_queue_batch);
+  expect("deque_t_queue_batch < 3000ms", elapsed < 3000);
+  expect("deque_t_queue_batch size", deque_t_size(d) == 2500000);
+
+  deque_t_destroy(d);
+
+  return 0;
+}
+
+#define CVECTOR_TEST_THREADS 4
+
+typedef struct
+{
+  cvector_t *vector;
+  size_t count;
+  size_t *values;
+} cvector_t_producer;
+
+static void *cvector_t_produce(void *arg)
+{
+  cvector_t_producer *p = arg;
+
+  for (size_t i = 0; i < p->count; i++)
+    cvector_t_push(p->vector, &p->values[i]);
+
+  return NULL;
+}
+
+/**
+ * @brief pushes `size` members from `CVECTOR_TEST_THREADS` threads at once
+ */
+static void cvector_t_push_batch(cvector_t *v, size_t *values, const size_t size)
+{
+  cvector_t_producer producers[CVECTOR_TEST_THREADS];
+  pthread_t ids[CVECTOR_TEST_THREADS];
+  size_t share = size / CVECTOR_TEST_THREADS;
+
+  for (size_t t = 0; t < CVECTOR_TEST_THREADS; t++)
+  {
+    producers[t].vector = v;
+    producers[t].count = share;
+    producers[t].values = &values[t * share];
+    pthread_create(&ids[t], NULL, cvector_t_produce, &producers[t]);
+  }
+
+  for (size_t t = 0; t < CVECTOR_TEST_THREADS; t++)
+    pthread_join(ids[t], NULL);
+}
+
+static char *test_cvector_t()
+{
+  cvector_t *v = cvector_t_create();
+  size_t size = 1 << 20;
+  size_t *values = malloc_realloc(sizeof(size_t) * size, NULL);
+  char *seen = calloc(size, 1);
+  int s1 = 42;
+
+  expect("cvector_t_size (0)", cvector_t_size(v) == 0);
+  expect("cvector_t_get (empty)", cvector_t_get(v, 0) == NULL);
+
+  for (size_t i = 0; i < size; i++)
+    values[i] = i;
+
+  cvector_t_push_batch(v, values, size);
+
+  expect("cvector_t_size", cvector_t_size(v) == size);
+
+  // every member landed exactly once
+  for (size_t i = 0; i < size; i++)
+  {
+    size_t *item = cvector_t_get(v, i);
+    expect("cvector_t_get", item != NULL && *item < size && !seen[*item]);
+    seen[*item] = 1;
+  }
+
+  void *first = cvector_t_get(v, 0);
+  expect("cvector_t_push index", cvector_t_push(v, &s1) == size);
+  expect("cvector_t_get (pushed)", cvector_t_get(v, size) == &s1);
+  expect("cvector_t_get (stable)", cvector_t_get(v, 0) == first);
+  expect("cvector_t_get (out of bounds)", cvector_t_get(v, size + 1) == NULL);
+
+  free(seen);
+  free(values);
+  cvector_t_destroy(v);
+
+  return 0;
+}
+
+static void t_test_check_sequence(void *item, const size_t index, void *context)
+{
+  vector_t *model = context;
+
+  // flags a mismatch by clearing the model member
+  if (item != *(void **)vector_t_get(model, index))
+    vector_t_set(model, index, NULL);
+}
+
+static char *test_sequence_t()
+{
+  sequence_t *q = sequence_t_create();
+  vector_t *model = vector_t_create_sized(sizeof(void *), 0);
+  static int s[128];
+  unsigned int seed = 7;
+
+  expect("sequence_t_size (0)", sequence_t_size(q) == 0);
+  expect("sequence_t_get (empty)", sequence_t_get(q, 0) == NULL);
+
+  // mirrors random edits on a sized vector of pointers, growing then shrinking the tree
+  for (size_t i = 0; i < 60000; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    size_t size = sequence_t_size(q);
+    size_t index = size > 0 ? (seed >> 8) % (size + 1) : 0;
+    void *item = &s[(seed >> 4) % 128];
+    int op = (seed >> 20) % 10;
+
+    if (i > 40000 && op < 6)
+      op = 8;
+
+    if (op < 5)
+    {
+      sequence_t_insert(q, index, item);
+      vector_t_insert(model, index, &item);
+    }
+    else if (op < 6)
+    {
+      sequence_t_push(q, item);
+      vector_t_push(model, &item);
+    }
+    else if (op < 8 && index < size)
+    {
+      sequence_t_set(q, index, item);
+      vector_t_set(model, index, &item);
+    }
+    else if (index < size)
+    {
+      size_t count = (seed >> 12) % (op == 9 ? 300 : 3) + 1;
+      sequence_t_remove(q, index, count);
+      vector_t_remove(model, index, count);
+    }
+
+    expect("sequence_t_size", sequence_t_size(q) == vector_t_size(model));
+  }
+
+  for (size_t i = 0; i < sequence_t_size(q); i++)
+    expect("sequence_t_get", sequence_t_get(q, i) == *(void **)vector_t_get(model, i));
+
+  sequence_t_for_each(q, t_test_check_sequence, model);
+
+  for (size_t i = 0; i < sequence_t_size(q); i++)
+    expect("sequence_t_for_each", *(void **)vector_t_get(model, i) != NULL);
+
+  sequence_t_remove(q, 0, sequence_t_size(q) + 10);
+  expect("sequence_t_remove (all)", sequence_t_size(q) == 0);
+
+  sequence_t_insert(q, 5, &s[0]);
+  expect("sequence_t_insert (past end)", sequence_t_size(q) == 1 && sequence_t_get(q, 0) == &s[0]);
+
+  vector_t_destroy(model);
+  sequence_t_destroy(q);
+
+  return 0;
+}
+
+static void sequence_t_insert_random_batch(sequence_t *q, size_t size)
+{
+  t_test s1 = {42};
+
+  for (size_t i = 0; i < size; i++)
+    sequence_t_insert(q, (i * 7919) % (sequence_t_size(q) + 1), &s1);
+}
+
+static void vector_t_insert_random_batch(vector_t *v, size_t size)
+{
+  t_test s1 = {42};
+
+  for (size_t i = 0; i < size; i++)
+    vector_t_insert(v, (i * 7919) % (vector_t_length(v) + 1), &s1);
+}
+
+static char *test_sequence_t_performance()
+{
+  sequence_t *q = sequence_t_create();
+  vector_t *v = vector_t_create(0);
+  t_test s1 = {42};
+  int elapsed, flat;
+
+  for (size_t i = 0; i < 1000000; i++)
+  {
+    sequence_t_push(q, &s1);
+    vector_t_push(v, &s1);
+  }
+
+  // 1M members, edits at spread out positions, `vector_t` gets 50 times fewer of them
+  elapsed = with_elapsed_sequence(q, 10000, sequence_t_insert_random_batch);
+  flat = with_elapsed(v, 200, vector_t_insert_random_batch);
+  report("sequence_t_insert_random_batch (10000)", elapsed, "vector_t_insert_random_batch (200)", flat);
+  expect("sequence_t_insert_random_batch (1M) < 200ms", elapsed < 200);
+
+  vector_t_destroy(v);
+
+  while (sequence_t_size(q) < 10000000)
+    sequence_t_push(q, &s1);
+
+  elapsed = with_elapsed_sequence(q, 10000, sequence_t_insert_random_batch);
+  expect("sequence_t_insert_random_batch (10M) < 300ms", elapsed < 300);
+  expect("sequence_t_insert_random_batch size", sequence_t_size(q) == 10010000);
+
+  sequence_t_destroy(q);
+
+  return 0;
+}
+
+static void t_test_check_ulist(void *item, const size_t index, void *context)
+{
+  size_t *expected = context;
+
+  if ((size_t)item != index)
+    expected[1]++;
+
+  expected[0]++;
+}
+
+static char *test_ulist_t()
+{
+  ulist_t *u = ulist_t_create();
+  ulist_t_iterator iter;
+
+  expect("ulist_t_size empty", ulist_t_size(u) == 0);
+  expect("ulist_t_shift empty", ulist_t_shift(u) == NULL);
+
+  ulist_t_iterator_init(&iter, u);
+  expect("ulist_t_iterator empty", !ulist_t_iterator_has_next(&iter) && ulist_t_iterator_next(&iter) == NULL);
+
+  // members hold their own position, so order is checked by value
+  for (size_t i = 100; i < 200; i++)
+    ulist_t_push(u, (void *)i);
+
+  for (size_t i = 100; i > 50; i--)
+    ulist_t_unshift(u, (void *)(i - 1));
+
+  expect("ulist_t_size", ulist_t_size(u) == 150);
+
+  for (size_t i = 0; i < 50; i++)
+    expect("ulist_t_shift", ulist_t_shift(u) == (void *)(50 + i));
+
+  expect("ulist_t_size", ulist_t_size(u) == 100);
+
+  // inserts 0..99 around the existing 100..199, 14 at once splits full nodes
+  ulist_t_iterator_init(&iter, u);
+
+  for (size_t i = 0; i < 100; i++)
+    ulist_t_iterator_insert(&iter, (void *)i);
+
+  expect("ulist_t_iterator_insert", ulist_t_iterator_next(&iter) == (void *)100);
+
+  // and past the end of the list
+  while (ulist_t_iterator_has_next(&iter))
+    ulist_t_iterator_next(&iter);
+
+  for (size_t i = 200; i < 250; i++)
+    ulist_t_iterator_insert(&iter, (void *)i);
+
+  size_t checked[2] = {0, 0};
+  ulist_t_for_each(u, t_test_check_ulist, checked);
+  expect("ulist_t_for_each", checked[0] == 250 && checked[1] == 0);
+
+  ulist_t_iterator_init(&iter, u);
+  for (size_t i = 0; i < 250; i++)
+    expect("ulist_t_iterator_next", ulist_t_iterator_has_next(&iter) && ulist_t_iterator_next(&iter) == (void *)i);
+
+  expect("ulist_t_iterator end", !ulist_t_iterator_has_next(&iter));
+
+  ulist_t *other = ulist_t_create();
+
+  for (size_t i = 250; i < 300; i++)
+    ulist_t_push(other, (void *)i);
+
+  ulist_t_concat(u, other);
+  expect("ulist_t_concat", ulist_t_size(u) == 300 && ulist_t_size(other) == 0);
+
+  checked[0] = checked[1] = 0;
+  ulist_t_for_each(u, t_test_check_ulist, checked);
+  expect("ulist_t_concat order", checked[0] == 300 && checked[1] == 0);
+
+  ulist_t_concat(other, u);
+  expect("ulist_t_concat into empty", ulist_t_size(other) == 300 && ulist_t_size(u) == 0);
+
+  while (ulist_t_size(other) > 0)
+    ulist_t_shift(other);
+
+  ulist_t_push(other, (void *)1);
+  expect("ulist_t_push after shift", ulist_t_shift(other) == (void *)1);
+
+  // the empty list takes an insert through a fresh iterator
+  ulist_t_iterator_init(&iter, u);
+  ulist_t_iterator_insert(&iter, (void *)7);
+  expect("ulist_t_iterator_insert empty", ulist_t_size(u) == 1 && ulist_t_shift(u) == (void *)7);
+
+  ulist_t_destroy(other);
+  ulist_t_destroy(u);
+
+  return 0;
+}
+
+#define ULIST_TEST_LISTS 16
+
+static void ulist_t_walk_batch(ulist_t *u, size_t *sum)
+{
+  ulist_t_iterator iter;
+  ulist_t_iterator_init(&iter, u);
+
+  while (ulist_t_iterator_has_next(&iter))
+    *sum += (size_t)ulist_t_iterator_next(&iter);
+}
+
+static void list_t_walk_batch(list_t *l, size_t *sum)
+{
+  for (node_t *n = list_t_head(l); n != NULL; n = node_t_next(n))
+    *sum += (size_t)node_t_peek(n);
+}
+
+static char *test_ulist_t_performance()
+{
+  list_t *lists[ULIST_TEST_LISTS];
+  ulist_t *ulists[ULIST_TEST_LISTS];
+  struct timespec start, middle, end;
+  size_t a = 0, b = 0;
+
+  for (size_t i = 0; i < ULIST_TEST_LISTS; i++)
+  {
+    lists[i] = list_t_create();
+    ulists[i] = ulist_t_create();
+  }
+
+  // lists filled in turns, as long-lived queues are, have their nodes spread over the heap
+  for (size_t i = 0; i < 1000000; i++)
+  {
+    list_t_push(lists[i % ULIST_TEST_LISTS], (void *)i);
+    ulist_t_push(ulists[i % ULIST_TEST_LISTS], (void *)i);
+  }
+
+  for (size_t i = 1; i < ULIST_TEST_LISTS; i++)
+  {
+    list_t_concat(lists[0], lists[i]);
+    ulist_t_concat(ulists[0], ulists[i]);
+    list_t_destroy(lists[i]);
+    ulist_t_destroy(ulists[i]);
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  list_t_walk_batch(lists[0], &a);
+  clock_gettime(CLOCK_MONOTONIC, &middle);
+  ulist_t_walk_batch(ulists[0], &b);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  int nodes = (middle.tv_sec - start.tv_sec) * 1000 + (middle.tv_nsec - start.tv_nsec) / 1000000;
+  int unrolled = (end.tv_sec - middle.tv_sec) * 1000 + (end.tv_nsec - middle.tv_nsec) / 1000000;
+
+  expect("ulist_t_walk_batch sum", a == b);
+  expect("ulist_t_walk_batch < 500ms", unrolled < 500);
+  report("ulist_t_walk_batch", unrolled, "list_t_walk_batch", nodes);
+
+  list_t_destroy(lists[0]);
+  ulist_t_destroy(ulists[0]);
 
-  node_t_destroy(head);
   return 0;
 }
 
@@ -540,12 +2815,48 @@ static char *all_tests()
   test(test_vector_t_compact);
   test(test_vector_t_mutations);
   test(test_vector_t_copy);
+  test(test_vector_t_copy_on_write);
+  test(test_vector_t_remove_if);
   test(test_vector_t_reverse);
   test(test_vector_t_clean);
+  test(test_vector_t_capacity);
+  test(test_vector_t_small);
+  test(test_vector_t_sized);
+  test(test_vector_t_align);
+  test(test_vector_t_open_mmap);
+  test(test_vector_t_save_load);
+  test(test_vector_t_bulk);
+  test(test_vector_t_bitmap);
+  test(test_vector_t_sort);
+  test(test_vector_t_gap_buffer);
   test(test_vector_t_iterator);
+  test(test_vector_t_iterator_init);
   test(test_vector_t_performance);
+  test(test_vector_t_compact_performance);
+  test(test_vector_t_sort_performance);
+  test(test_vector_t_copy_performance);
+  test(test_vector_t_remove_if_performance);
+  test(test_vector_type);
+  test(test_vector_type_performance);
   test(test_matrix_t);
   test(test_node_t);
+  test(test_list_t);
+  test(test_list_t_performance);
+  test(test_heap_stats);
+  test(test_vector_t_stats);
+  test(test_node_t_stats);
+  test(test_allocator);
+  test(test_arena);
+  test(test_arena_performance);
+  test(test_pool);
+  test(test_pool_performance);
+  test(test_deque_t);
+  test(test_deque_t_performance);
+  test(test_cvector_t);
+  test(test_sequence_t);
+  test(test_sequence_t_performance);
+  test(test_ulist_t);
+  test(test_ulist_t_performance);
 
   return 0;
 }
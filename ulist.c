@@ -0,0 +1,258 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file ulist.c
+ * @brief Implementation of the unrolled linked list
+ * @version 0.1
+ * @date 2024-08-17
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "heap.h"
+#include "ulist.h"
+
+/**
+ * Nodes fill two cache lines, members are kept packed at the start of `items`.
+ * Only empty lists have empty nodes: none at all.
+ */
+#define ULIST_NODE_BYTES 128
+#define ULIST_ITEMS ((ULIST_NODE_BYTES - sizeof(void *) - sizeof(size_t)) / sizeof(void *))
+
+typedef struct ulist_node
+{
+  struct ulist_node *next;
+  size_t count;
+  void *items[ULIST_ITEMS];
+} ulist_node;
+
+struct ulist_t
+{
+  ulist_node *head;
+  ulist_node *tail;
+  size_t size;
+  const allocator_t *allocator;
+};
+
+static ulist_node *ulist_node_create(const ulist_t *list, ulist_node *next)
+{
+  ulist_node *node = list->allocator->alloc(sizeof(ulist_node), list->allocator->context);
+
+  node->next = next;
+  node->count = 0;
+
+  return node;
+}
+
+/**
+ * @brief moves the upper half of a full `node` to a new node right after it
+ */
+static void ulist_node_split(ulist_t *list, ulist_node *node)
+{
+  ulist_node *right = ulist_node_create(list, node->next);
+  size_t half = node->count / 2;
+
+  right->count = node->count - half;
+  memcpy(right->items, &node->items[half], right->count * sizeof(void *));
+  node->count = half;
+  node->next = right;
+
+  if (list->tail == node)
+    list->tail = right;
+}
+
+/**
+ * @brief inserts `item` at `index` of a node with room for it
+ */
+static inline void ulist_node_insert(ulist_node *node, const size_t index, void *item)
+{
+  memmove(&node->items[index + 1], &node->items[index], (node->count - index) * sizeof(void *));
+  node->items[index] = item;
+  node->count++;
+}
+
+ulist_t *ulist_t_create(void)
+{
+  return ulist_t_create_with_allocator(&heap_allocator);
+}
+
+ulist_t *ulist_t_create_with_allocator(const allocator_t *allocator)
+{
+  ulist_t *list = allocator->alloc(sizeof(ulist_t), allocator->context);
+
+  list->head = NULL;
+  list->tail = NULL;
+  list->size = 0;
+  list->allocator = allocator;
+
+  return list;
+}
+
+void ulist_t_destroy(ulist_t *list)
+{
+  if (list == NULL)
+    return;
+
+  const allocator_t *allocator = list->allocator;
+
+  while (list->head != NULL)
+  {
+    ulist_node *next = list->head->next;
+    allocator->free(list->head, sizeof(ulist_node), allocator->context);
+    list->head = next;
+  }
+
+  allocator->free(list, sizeof(ulist_t), allocator->context);
+}
+
+size_t ulist_t_size(const ulist_t *list)
+{
+  return list->size;
+}
+
+void ulist_t_push(ulist_t *list, void *item)
+{
+  if (list->tail == NULL)
+  {
+    list->head = list->tail = ulist_node_create(list, NULL);
+  }
+  else if (list->tail->count == ULIST_ITEMS)
+  {
+    list->tail->next = ulist_node_create(list, NULL);
+    list->tail = list->tail->next;
+  }
+
+  list->tail->items[list->tail->count++] = item;
+  list->size++;
+}
+
+void ulist_t_unshift(ulist_t *list, void *item)
+{
+  if (list->head == NULL || list->head->count == ULIST_ITEMS)
+  {
+    list->head = ulist_node_create(list, list->head);
+
+    if (list->tail == NULL)
+      list->tail = list->head;
+  }
+
+  ulist_node_insert(list->head, 0, item);
+  list->size++;
+}
+
+void *ulist_t_shift(ulist_t *list)
+{
+  ulist_node *head = list->head;
+
+  if (head == NULL)
+    return NULL;
+
+  void *item = head->items[0];
+
+  head->count--;
+  memmove(head->items, &head->items[1], head->count * sizeof(void *));
+  list->size--;
+
+  if (head->count == 0)
+  {
+    list->head = head->next;
+
+    if (list->head == NULL)
+      list->tail = NULL;
+
+    list->allocator->free(head, sizeof(ulist_node), list->allocator->context);
+  }
+
+  return item;
+}
+
+void ulist_t_concat(ulist_t *list, ulist_t *other)
+{
+  if (list == other || other->head == NULL)
+    return;
+
+  if (list->tail == NULL)
+    list->head = other->head;
+  else
+    list->tail->next = other->head;
+
+  list->tail = other->tail;
+  list->size += other->size;
+
+  other->head = NULL;
+  other->tail = NULL;
+  other->size = 0;
+}
+
+void ulist_t_for_each(const ulist_t *list, ulist_t_visit visit, void *context)
+{
+  size_t index = 0;
+
+  for (ulist_node *node = list->head; node != NULL; node = node->next)
+    for (size_t i = 0; i < node->count; i++)
+      visit(node->items[i], index++, context);
+}
+
+void ulist_t_iterator_init(ulist_t_iterator *iter, ulist_t *list)
+{
+  iter->list = list;
+  iter->node = list->head;
+  iter->index = 0;
+}
+
+int ulist_t_iterator_has_next(const ulist_t_iterator *iter)
+{
+  const ulist_node *node = iter->node;
+
+  // the end of a node is the start of the next one, nodes are never empty
+  return node != NULL && (iter->index < node->count || node->next != NULL);
+}
+
+void *ulist_t_iterator_next(ulist_t_iterator *iter)
+{
+  ulist_node *node = iter->node;
+
+  if (node == NULL)
+    return NULL;
+
+  if (iter->index == node->count)
+  {
+    if (node->next == NULL)
+      return NULL;
+
+    iter->node = node = node->next;
+    iter->index = 0;
+  }
+
+  return node->items[iter->index++];
+}
+
+void ulist_t_iterator_insert(ulist_t_iterator *iter, void *item)
+{
+  ulist_node *node = iter->node;
+
+  if (node == NULL)
+  {
+    // only an empty list has no node
+    ulist_t_unshift(iter->list, item);
+    iter->node = iter->list->head;
+    iter->index = 1;
+    return;
+  }
+
+  if (node->count == ULIST_ITEMS)
+  {
+    ulist_node_split(iter->list, node);
+
+    if (iter->index > node->count)
+    {
+      iter->index -= node->count;
+      iter->node = node = node->next;
+    }
+  }
+
+  ulist_node_insert(node, iter->index++, item);
+  iter->list->size++;
+}
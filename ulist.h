@@ -0,0 +1,176 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file ulist.h
+ * @brief An unrolled linked list, several members per node
+ * @version 0.1
+ * @date 2024-08-17
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stddef.h>
+#include "heap.h"
+
+#ifndef ULIST_H
+#define ULIST_H
+
+/**
+ * @brief unrolled linked list container
+ *
+ * Each node is two cache lines holding up to 14 member pointers and their count, so walking the list
+ * takes one cache miss per 14 members instead of one per member as `node_t` does. Ends and positions
+ * found by an iterator are edited by moving at most one node of members.
+ */
+typedef struct ulist_t ulist_t;
+
+/**
+ * @brief iterator for `ulist_t`
+ *
+ * Exposed so it can live on the stack, see `ulist_t_iterator_init`.
+ * Members are private, use the `ulist_t_iterator_*` functions.
+ */
+typedef struct ulist_t_iterator
+{
+  ulist_t *list;
+  void *node;
+  size_t index;
+} ulist_t_iterator;
+
+/**
+ * @brief callback for `ulist_t_for_each`
+ *
+ * @param[in] item member
+ * @param[in] index position of the member
+ * @param[in] context pointer given to `ulist_t_for_each`
+ */
+typedef void (*ulist_t_visit)(void *item, const size_t index, void *context);
+
+/**
+ * @brief creates a new empty `ulist_t`
+ *
+ * @return `ulist_t*` pointer for created list
+ */
+ulist_t *ulist_t_create(void);
+
+/**
+ * @brief creates a new empty `ulist_t` whose handle and nodes come from `allocator`
+ *
+ * @param[in] allocator must outlive the list
+ * @return `ulist_t*` pointer for created list
+ */
+ulist_t *ulist_t_create_with_allocator(const allocator_t *allocator);
+
+/**
+ * @brief destroys `ulist_t` and its nodes, members are not freed
+ *
+ * @param[in] list
+ */
+void ulist_t_destroy(ulist_t *list);
+
+/**
+ * @brief retrieves the number of members of `ulist_t`
+ *
+ * @note `O(1)`
+ *
+ * @param[in] list
+ */
+size_t ulist_t_size(const ulist_t *list);
+
+/**
+ * @brief inserts member after the last one of `ulist_t`
+ *
+ * @note `O(1)`
+ *
+ * @param[in] list
+ * @param[in] item
+ */
+void ulist_t_push(ulist_t *list, void *item);
+
+/**
+ * @brief inserts member before the first one of `ulist_t`
+ *
+ * @note `O(1)`, moves the members of the first node
+ *
+ * @param[in] list
+ * @param[in] item
+ */
+void ulist_t_unshift(ulist_t *list, void *item);
+
+/**
+ * @brief removes and returns the first member of `ulist_t`
+ *
+ * @note `O(1)`, moves the members of the first node
+ *
+ * @param[in] list
+ * @return `void*` the member, `NULL` when empty
+ */
+void *ulist_t_shift(ulist_t *list);
+
+/**
+ * @brief moves all members of `other` after the last one of `list`, leaving `other` empty
+ *
+ * @note `O(1)`, nodes are relinked, not copied
+ * @warning both lists must use the same allocator
+ *
+ * @param[in] list
+ * @param[in] other
+ */
+void ulist_t_concat(ulist_t *list, ulist_t *other);
+
+/**
+ * @brief visits all members in order, one node after the other
+ *
+ * @note `O(n)`
+ *
+ * @param[in] list
+ * @param[in] visit
+ * @param[in] context passed to `visit`
+ */
+void ulist_t_for_each(const ulist_t *list, ulist_t_visit visit, void *context);
+
+/**
+ * @brief initializes an iterator in place at the first member of `ulist_t`
+ *
+ * Does not allocate. Editing the list other than through `ulist_t_iterator_insert` invalidates it.
+ *
+ * ```c
+ * ulist_t_iterator iter;
+ * ulist_t_iterator_init(&iter, list);
+ *
+ * while (ulist_t_iterator_has_next(&iter))
+ *   item = ulist_t_iterator_next(&iter);
+ * ```
+ *
+ * @param[out] iter
+ * @param[in] list
+ */
+void ulist_t_iterator_init(ulist_t_iterator *iter, ulist_t *list);
+
+/**
+ * @brief tells whether `ulist_t_iterator_next` has a member to return
+ *
+ * @param[in] iter
+ * @return 1 when there is a next member
+ */
+int ulist_t_iterator_has_next(const ulist_t_iterator *iter);
+
+/**
+ * @brief returns the next member and moves past it
+ *
+ * @param[in] iter
+ * @return `void*` the member, `NULL` at the end
+ */
+void *ulist_t_iterator_next(ulist_t_iterator *iter);
+
+/**
+ * @brief inserts member before the one `ulist_t_iterator_next` would return, the iterator stays after it
+ *
+ * @note `O(1)`, a full node is split in two halves
+ *
+ * @param[in] iter
+ * @param[in] item
+ */
+void ulist_t_iterator_insert(ulist_t_iterator *iter, void *item);
+
+#endif // ULIST_H
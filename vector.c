@@ -9,261 +9,2156 @@
  *
  */
 
+#define _GNU_SOURCE
 #include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "heap.h"
 #include "vector.h"
+#include "vector_simd.h"
+#include "vector_sort.h"
+#include "vector_io.h"
 
+/**
+ * @brief pointers kept inline in `vector_t` before `items` spills to the heap
+ */
+#define VECTOR_T_SMALL 8
+
+#ifdef VECTOR_STATS
+static vector_t_stats_t vector_t_counters;
+
+#define VECTOR_T_COUNT(counter, n) __atomic_add_fetch(&vector_t_counters.counter, (n), __ATOMIC_RELAXED)
+#else
+#define VECTOR_T_COUNT(counter, n)
+#endif
+
+struct vector_t_reader
+{
+  int fd;
+  vector_io_header header;
+  size_t read;
+};
+
+/**
+ * @brief state of shared, gap buffer, mapped, aligned and huge page vectors, allocated on first use
+ */
+typedef struct
+{
+  size_t *shared;
+  size_t gap_start;
+  size_t gap_length;
+  size_t stored;
+  size_t mapped;
+  size_t alignment;
+  size_t huge_mapped;
+  int fd;
+  int gap;
+  int gapped;
+  int huge;
+  int aligned;
+} vector_t_extension;
+
+/**
+ * Fields used on every access fit in one cache line, right before the inline buffer.
+ * The rest is behind `extension`, `NULL` for vectors that never needed it.
+ */
 struct vector_t
 {
   size_t size;
+  size_t length;
+  size_t capacity;
+  size_t width;
   void **items;
+  uint64_t *bits;
+  vector_t_extension *extension;
+  const allocator_t *allocator;
+  union
+  {
+    void *items[VECTOR_T_SMALL];
+    max_align_t align;
+  } small;
 };
 
-struct vector_t_iterator
+static const vector_t_extension vector_t_no_extension = {.fd = -1};
+
+/**
+ * @brief state behind `extension` for reading, defaults when there is none
+ */
+static inline const vector_t_extension *vector_t_ext(const vector_t *v)
 {
-  size_t cursor;
-  vector_t *vector;
-};
+  return v->extension != NULL ? v->extension : &vector_t_no_extension;
+}
 
-void vector_t_init(vector_t **v)
+/**
+ * @brief state behind `extension` for writing, allocated with the defaults on first use
+ *
+ * @return `NULL` when it can not be allocated
+ */
+static vector_t_extension *vector_t_ext_own(vector_t *v)
 {
-  *v = malloc_realloc(sizeof(**v), NULL);
+  if (v->extension != NULL)
+    return v->extension;
 
-  if (*v == NULL)
+  v->extension = v->allocator->alloc(sizeof(vector_t_extension), v->allocator->context);
+
+  if (v->extension != NULL)
+    *v->extension = vector_t_no_extension;
+
+  return v->extension;
+}
+
+/**
+ * @brief whether `items` is shared with copies
+ */
+static inline int vector_t_shared(const vector_t *v)
+{
+  return v->extension != NULL && v->extension->shared != NULL;
+}
+
+/**
+ * @brief whether `items` is the inline buffer of the vector
+ */
+static inline int vector_t_small(const vector_t *v)
+{
+  return v->items == v->small.items;
+}
+
+/**
+ * @brief bytes taken by `count` members of the vector
+ */
+static inline size_t vector_t_bytes(const vector_t *v, const size_t count)
+{
+  return count * (v->width > 0 ? v->width : sizeof(void *));
+}
+
+/**
+ * @brief address of member `index` in a sized vector
+ */
+static inline char *vector_t_at(const vector_t *v, const size_t index)
+{
+  return (char *)v->items + index * v->width;
+}
+
+/**
+ * @brief address of slot `index`, for both pointer and sized vectors
+ */
+static inline char *vector_t_slot(const vector_t *v, const size_t index)
+{
+  return (char *)v->items + vector_t_bytes(v, index);
+}
+
+/**
+ * @brief `memmove` of members shifted by an insert or remove
+ */
+static inline void vector_t_shift_bytes(void *destination, const void *source, const size_t bytes)
+{
+  VECTOR_T_COUNT(moved, bytes);
+  memmove(destination, source, bytes);
+}
+
+/**
+ * @brief whether `items` may be the inline buffer under the requested alignment
+ */
+static inline int vector_t_small_fits(const vector_t *v, const size_t capacity)
+{
+  return vector_t_bytes(v, capacity) <= sizeof(v->small) && vector_t_ext(v)->alignment <= _Alignof(max_align_t);
+}
+
+/**
+ * @brief frees a heap `items` buffer of `capacity` members, `aligned` ones come from `malloc_aligned`
+ */
+static inline void vector_t_heap_free(const vector_t *v, void **items, const size_t capacity, const int aligned)
+{
+  if (aligned)
+    heap_free(items);
+  else if (items != NULL)
+    v->allocator->free(items, vector_t_bytes(v, capacity), v->allocator->context);
+}
+
+/**
+ * @brief frees `items` as it was allocated: inline, allocator, aligned or mapped
+ */
+static void vector_t_release(vector_t *v)
+{
+  const vector_t_extension *e = vector_t_ext(v);
+
+  if (e->huge_mapped > 0)
+    heap_unmap(v->items, e->huge_mapped);
+  else if (!vector_t_small(v))
+    vector_t_heap_free(v, v->items, v->capacity, e->aligned);
+
+  if (v->extension != NULL)
+  {
+    v->extension->huge_mapped = 0;
+    v->extension->aligned = 0;
+  }
+}
+
+/**
+ * @brief moves `items` to a buffer of `capacity` members out of the inline one
+ *
+ * Huge page vectors map buffers of at least `HEAP_HUGE_THRESHOLD` bytes and grow them with `heap_remap`,
+ * aligned vectors copy to a new aligned allocation, others `realloc` through the allocator. Members up to the smaller
+ * capacity are kept.
+ *
+ * @return `0` on success, `-1` keeping the current buffer
+ */
+static int vector_t_realloc(vector_t *v, const size_t capacity)
+{
+  size_t bytes = vector_t_bytes(v, capacity);
+  size_t kept = vector_t_bytes(v, capacity < v->capacity ? capacity : v->capacity);
+  void **items = NULL;
+  const vector_t_extension *e = vector_t_ext(v);
+
+  // only vectors with an extension are huge
+  if (e->huge && bytes >= HEAP_HUGE_THRESHOLD)
+  {
+    if (e->huge_mapped > 0)
+    {
+      items = heap_remap(v->items, e->huge_mapped, bytes);
+
+      if (items != NULL)
+      {
+        v->items = items;
+        v->extension->huge_mapped = bytes;
+        return 0;
+      }
+    }
+    else if ((items = heap_map(bytes)) != NULL)
+    {
+      if (kept > 0)
+        memcpy(items, v->items, kept);
+
+      vector_t_release(v);
+      v->items = items;
+      v->extension->huge_mapped = bytes;
+      return 0;
+    }
+  }
+
+  if (e->alignment == 0 && e->huge_mapped == 0 && !e->aligned && !vector_t_small(v))
+  {
+    items = v->allocator->realloc(v->items, vector_t_bytes(v, v->capacity), bytes, v->allocator->context);
+
+    if (items == NULL)
+      return -1;
+
+    v->items = items;
+    return 0;
+  }
+
+  items = e->alignment > 0 ? malloc_aligned(bytes, e->alignment) : v->allocator->alloc(bytes, v->allocator->context);
+
+  if (items == NULL)
+    return -1;
+
+  if (kept > 0)
+    memcpy(items, v->items, kept);
+
+  vector_t_release(v);
+  v->items = items;
+
+  if (v->extension != NULL)
+    v->extension->aligned = e->alignment > 0;
+
+  return 0;
+}
+
+#define VECTOR_T_WORD_BITS 64
+#define VECTOR_T_WORDS(n) (((n) + VECTOR_T_WORD_BITS - 1) / VECTOR_T_WORD_BITS)
+
+/**
+ * @brief bytes of the bitmap of `capacity` slots, one extra word so a 0-capacity vector still has a bitmap
+ */
+static inline size_t vector_t_bits_bytes(const size_t capacity)
+{
+  return sizeof(uint64_t) * (VECTOR_T_WORDS(capacity) + 1);
+}
+
+/**
+ * @brief updates the occupancy bit of slot `index`
+ */
+static inline void vector_t_bit(vector_t *v, const size_t index, const int used)
+{
+  uint64_t mask = (uint64_t)1 << (index % VECTOR_T_WORD_BITS);
+
+  if (used)
+    v->bits[index / VECTOR_T_WORD_BITS] |= mask;
+  else
+    v->bits[index / VECTOR_T_WORD_BITS] &= ~mask;
+}
+
+/**
+ * @brief rebuilds occupancy bits for slots in `[from, to)` out of `items`
+ */
+static void vector_t_bits_refresh(vector_t *v, const size_t from, const size_t to)
+{
+  if (v->bits == NULL)
     return;
 
-  (*v)->size = 0;
-  (*v)->items = NULL;
+  for (size_t i = from; i < to; i++)
+    vector_t_bit(v, i, v->items[i] != NULL);
 }
 
-vector_t *vector_t_create(size_t size)
+/**
+ * @brief sets occupancy bits for slots in `[from, to)` to `used`, word at a time
+ */
+static void vector_t_bits_fill(vector_t *v, size_t from, const size_t to, const int used)
 {
-  vector_t *v = NULL;
-  vector_t_init(&v);
+  if (v->bits == NULL)
+    return;
 
-  if (size > 0)
+  for (; from < to && from % VECTOR_T_WORD_BITS != 0; from++)
+    vector_t_bit(v, from, used);
+
+  for (; from + VECTOR_T_WORD_BITS <= to; from += VECTOR_T_WORD_BITS)
+    v->bits[from / VECTOR_T_WORD_BITS] = used ? ~(uint64_t)0 : 0;
+
+  for (; from < to; from++)
+    vector_t_bit(v, from, used);
+}
+
+/**
+ * @brief grows capacity geometrically until it fits `size` slots
+ *
+ * @return `0` on success, `-1` leaving the vector unchanged
+ */
+static int vector_t_grow(vector_t *v, const size_t size)
+{
+  if (size <= v->capacity)
+    return 0;
+
+  size_t capacity = v->capacity > 0 ? v->capacity : 4;
+
+  // past half the address space doubling would wrap, the exact size is asked for instead
+  while (capacity < size)
+    capacity = capacity <= SIZE_MAX / 2 ? capacity * 2 : size;
+
+  return vector_t_reserve(v, capacity);
+}
+
+/**
+ * @brief grows `size` up to given `size`, setting new slots to `NULL` (or zero)
+ *
+ * @return `0` on success, `-1` leaving the vector unchanged
+ */
+static int vector_t_extend(vector_t *v, const size_t size)
+{
+  if (vector_t_grow(v, size) != 0)
+    return -1;
+
+  if (v->width > 0)
+  {
+    memset(vector_t_at(v, v->size), 0, (size - v->size) * v->width);
+    v->length = size;
+  }
+  else
+  {
+    for (size_t i = v->size; i < size; i++)
+      v->items[i] = NULL;
+  }
+
+  v->size = size;
+
+  return 0;
+}
+
+/**
+ * @brief moves `length` back to the last non-null member
+ */
+static void vector_t_trim(vector_t *v)
+{
+#ifdef VECTOR_STATS
+  size_t length = v->length;
+#endif
+
+  if (v->bits != NULL)
+  {
+    size_t word = VECTOR_T_WORDS(v->length);
+    uint64_t w;
+
+    while (word > 0)
+    {
+      w = v->bits[--word];
+
+      // ignore bits at or after `length` in the last word
+      if ((word + 1) * VECTOR_T_WORD_BITS > v->length)
+        w &= ((uint64_t)1 << (v->length % VECTOR_T_WORD_BITS)) - 1;
+
+      if (w != 0)
+      {
+        v->length = word * VECTOR_T_WORD_BITS + (VECTOR_T_WORD_BITS - __builtin_clzll(w));
+        VECTOR_T_COUNT(scanned, length - v->length);
+        return;
+      }
+    }
+
+    v->length = 0;
+    VECTOR_T_COUNT(scanned, length);
+    return;
+  }
+
+  v->length = vector_simd_last(v->items, v->length);
+  VECTOR_T_COUNT(scanned, length - v->length);
+}
+
+/**
+ * @brief keeps `length` in sync after slot `index` was written
+ */
+static void vector_t_track(vector_t *v, const size_t index)
+{
+  if (v->bits != NULL)
+    vector_t_bit(v, index, v->items[index] != NULL);
+
+  if (v->items[index] != NULL)
+  {
+    if (index >= v->length)
+      v->length = index + 1;
+  }
+  else if (index + 1 == v->length)
+  {
+    vector_t_trim(v);
+  }
+}
+
+/**
+ * @brief swaps `width` bytes between two sized members
+ */
+static void vector_t_swap_bytes(char *a, char *b, size_t width)
+{
+  char t;
+
+  while (width-- > 0)
+  {
+    t = *a;
+    *a++ = *b;
+    *b++ = t;
+  }
+}
+
+/**
+ * Gap buffer layout
+ *
+ * While `gapped`, positions `[0, stored)` are kept as `[0, gap_start)`, then `gap_length` unused
+ * slots, then `[gap_start, stored)`. Pointer positions in `[stored, size)` are `NULL` and not kept.
+ * Inserting and removing at the gap only moves members between the gap and the edit position.
+ * Gap buffer vectors always have an `extension`, the functions below use it directly.
+ */
+
+/**
+ * @brief slot holding position `index` of a gapped vector
+ */
+static inline size_t vector_t_gap_slot(const vector_t *v, const size_t index)
+{
+  return index < v->extension->gap_start ? index : index + v->extension->gap_length;
+}
+
+/**
+ * @brief switches a flat layout to the gap layout, gap at the end
+ */
+static void vector_t_gap_open(vector_t *v)
+{
+  vector_t_extension *e = v->extension;
+
+  if (e->gapped)
+    return;
+
+  e->gap_start = v->size;
+  e->gap_length = 0;
+  e->stored = v->size;
+  e->gapped = 1;
+}
+
+/**
+ * @brief moves the gap to position `index`, moving only the members in between
+ */
+static void vector_t_gap_move(vector_t *v, const size_t index)
+{
+  vector_t_extension *e = v->extension;
+
+  if (index < e->gap_start)
+    vector_t_shift_bytes(vector_t_slot(v, index + e->gap_length), vector_t_slot(v, index), vector_t_bytes(v, e->gap_start - index));
+  else if (index > e->gap_start)
+    vector_t_shift_bytes(vector_t_slot(v, e->gap_start), vector_t_slot(v, e->gap_start + e->gap_length), vector_t_bytes(v, index - e->gap_start));
+
+  e->gap_start = index;
+}
+
+/**
+ * @brief makes room for at least one member in the gap
+ *
+ * @return `0` on success, `-1` leaving the vector unchanged
+ */
+static int vector_t_gap_reserve(vector_t *v)
+{
+  vector_t_extension *e = v->extension;
+
+  if (e->gap_length > 0)
+    return 0;
+
+  size_t tail = e->stored - e->gap_start;
+
+  if (vector_t_grow(v, e->stored + (e->stored / 2 > 16 ? e->stored / 2 : 16)) != 0)
+    return -1;
+
+  // place the tail at the end, the gap takes all the spare capacity
+  vector_t_shift_bytes(vector_t_slot(v, v->capacity - tail), vector_t_slot(v, e->gap_start), vector_t_bytes(v, tail));
+  e->gap_length = v->capacity - e->stored;
+
+  return 0;
+}
+
+/**
+ * @brief goes back to the flat layout, moving the gap to the end
+ */
+static void vector_t_gap_close(vector_t *v)
+{
+  vector_t_extension *e = v->extension;
+
+  if (e == NULL || !e->gapped)
+    return;
+
+  vector_t_gap_move(v, e->stored);
+  e->gap_length = 0;
+  e->gapped = 0;
+
+  // positions not kept in the gap layout are NULL, they are dropped when there is no room for them
+  if (vector_t_grow(v, v->size) != 0)
+    v->size = e->stored;
+
+  memset(vector_t_slot(v, e->stored), 0, vector_t_bytes(v, v->size - e->stored));
+}
+
+/**
+ * @brief makes the layout flat before raw access to `items`
+ */
+static inline void vector_t_flat(vector_t *v)
+{
+  if (v->extension != NULL && v->extension->gapped)
+    vector_t_gap_close(v);
+}
+
+/**
+ * Copies share `items` through a reference count in `shared`, `NULL` while the buffer has a single owner.
+ * Owners take their own buffer before the first write, the last one to let go frees the shared one.
+ * Writers check `vector_t_shared` inline before calling this, it is on the insert and push paths.
+ *
+ * @return `0` on success, `-1` when no buffer could be allocated, the vector still shares the old one
+ */
+static int vector_t_unshare(vector_t *v)
+{
+  vector_t_extension *e = v->extension;
+
+  // no other owner left, nobody else can copy it again
+  if (__atomic_load_n(e->shared, __ATOMIC_ACQUIRE) == 1)
+  {
+    v->allocator->free(e->shared, sizeof(size_t), v->allocator->context);
+    e->shared = NULL;
+    return 0;
+  }
+
+  void **items = v->items;
+  size_t *shared = e->shared;
+  size_t capacity = v->capacity;
+  int aligned = e->aligned;
+
+  // a fresh buffer of the same kind, shared ones are always on the heap
+  v->items = NULL;
+  e->shared = NULL;
+  v->capacity = 0;
+  e->aligned = 0;
+
+  if (vector_t_realloc(v, capacity) != 0)
+  {
+    v->items = items;
+    e->shared = shared;
+    v->capacity = capacity;
+    e->aligned = aligned;
+    return -1;
+  }
+
+  v->capacity = capacity;
+
+  memcpy(v->items, items, vector_t_bytes(v, v->size));
+
+  if (__atomic_sub_fetch(shared, 1, __ATOMIC_ACQ_REL) == 0)
+  {
+    vector_t_heap_free(v, items, capacity, aligned);
+    v->allocator->free(shared, sizeof(size_t), v->allocator->context);
+  }
+
+  return 0;
+}
+
+/**
+ * @brief `vector_t_set` for a position kept in the gap layout
+ */
+static void vector_t_gap_set(vector_t *v, const size_t index, void *item)
+{
+  size_t slot = vector_t_gap_slot(v, index);
+
+  if (v->width > 0)
+  {
+    if (item != NULL)
+      memcpy(vector_t_slot(v, slot), item, v->width);
+    else
+      memset(vector_t_slot(v, slot), 0, v->width);
+
+    return;
+  }
+
+  v->items[slot] = item;
+
+  if (item != NULL)
+  {
+    if (index >= v->length)
+      v->length = index + 1;
+  }
+  else if (index + 1 == v->length)
+  {
+    // positions before the gap are in place, trim can scan them
+    vector_t_gap_move(v, v->length);
+    vector_t_trim(v);
+  }
+}
+
+/**
+ * @brief `vector_t_insert` moving the gap to `index`
+ *
+ * @return 0 when the insert must be done in the flat layout
+ */
+static int vector_t_gap_insert(vector_t *v, const size_t index, void *item)
+{
+  vector_t_extension *e = v->extension;
+
+  if (v->width > 0 ? index > v->size : index >= (e->gapped ? e->stored : v->size))
+    return 0;
+
+  vector_t_gap_open(v);
+
+  // free position, nothing to move
+  if (v->width == 0 && v->items[vector_t_gap_slot(v, index)] == NULL)
+  {
+    vector_t_gap_set(v, index, item);
+    return 1;
+  }
+
+  vector_t_gap_move(v, index);
+
+  if (vector_t_gap_reserve(v) != 0)
+    return 0;
+
+  e->gap_start++;
+  e->gap_length--;
+  e->stored++;
+
+  if (v->width > 0)
+  {
+    v->size++;
+    v->length = v->size;
+  }
+  else if (v->length++ == v->size)
+  {
+    // last position was taken, shifting needs one more
+    v->size++;
+  }
+  else if (e->stored > v->size)
+  {
+    // last position was NULL and goes away with the shift
+    e->stored = v->size;
+  }
+
+  vector_t_gap_set(v, index, item);
+
+  return 1;
+}
+
+/**
+ * @brief `vector_t_remove` growing the gap over the removed members
+ */
+static void vector_t_gap_remove(vector_t *v, const size_t index, const size_t count)
+{
+  size_t tail = v->length - index;
+  size_t removed = count < tail ? count : tail;
+
+  vector_t_gap_open(v);
+  vector_t_gap_move(v, index);
+
+  v->extension->gap_length += removed;
+  v->extension->stored -= removed;
+
+  if (v->width > 0)
+  {
+    v->size -= removed;
+    v->length = v->size;
+  }
+  else if (removed < tail)
+  {
+    v->length -= removed;
+  }
+  else
+  {
+    // gap is at `index`, positions before it are in place
+    v->length = index;
+    vector_t_trim(v);
+  }
+}
+
+/**
+ * File layout of mapped vectors: a header of `VECTOR_T_MAP_HEADER` bytes followed by the members,
+ * the file is as long as the capacity, `size` tells how many of them are in use.
+ */
+#define VECTOR_T_MAP_MAGIC "VECTORT"
+#define VECTOR_T_MAP_VERSION 1
+#define VECTOR_T_MAP_HEADER 64
+
+typedef struct
+{
+  char magic[8];
+  uint64_t version;
+  uint64_t width;
+  uint64_t size;
+} vector_t_map_header;
+
+static inline vector_t_map_header *vector_t_map_base(const vector_t *v)
+{
+  return (vector_t_map_header *)((char *)v->items - VECTOR_T_MAP_HEADER);
+}
+
+/**
+ * @brief resizes the file and its mapping to hold `capacity` members
+ *
+ * @return `0` on success, `-1` leaving the vector unchanged
+ */
+static int vector_t_map(vector_t *v, const size_t capacity)
+{
+  vector_t_extension *e = v->extension;
+  size_t bytes = VECTOR_T_MAP_HEADER + vector_t_bytes(v, capacity);
+  void *map;
+
+  // the file grows before the mapping and shrinks after it, pages past its end fault
+  if (bytes > e->mapped && ftruncate(e->fd, bytes) != 0)
+    return -1;
+
+  if (e->mapped == 0)
+    map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, e->fd, 0);
+  else
+#ifdef MREMAP_MAYMOVE
+    map = mremap(vector_t_map_base(v), e->mapped, bytes, MREMAP_MAYMOVE);
+#else
+  {
+    munmap(vector_t_map_base(v), e->mapped);
+    map = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, e->fd, 0);
+  }
+#endif
+
+  if (map == MAP_FAILED)
+    return -1;
+
+  if (bytes < e->mapped)
+    ftruncate(e->fd, bytes);
+
+  v->items = (void **)((char *)map + VECTOR_T_MAP_HEADER);
+  e->mapped = bytes;
+  v->capacity = capacity;
+
+  return 0;
+}
+
+/**
+ * @brief writes the current size to the header of a mapped vector
+ */
+static void vector_t_map_size(vector_t *v)
+{
+  vector_t_flat(v);
+  vector_t_map_base(v)->size = v->size;
+}
+
+/**
+ * @brief allocates an empty vector through `allocator`
+ */
+static void vector_t_init_with_allocator(vector_t **v, const allocator_t *allocator)
+{
+  *v = allocator->alloc(sizeof(**v), allocator->context);
+
+  if (*v == NULL)
+    return;
+
+  (*v)->size = 0;
+  (*v)->length = 0;
+  (*v)->capacity = 0;
+  (*v)->width = 0;
+  (*v)->items = NULL;
+  (*v)->bits = NULL;
+  (*v)->extension = NULL;
+  (*v)->allocator = allocator;
+}
+
+void vector_t_init(vector_t **v)
+{
+  vector_t_init_with_allocator(v, &heap_allocator);
+}
+
+vector_t *vector_t_create(size_t size)
+{
+  return vector_t_create_with_allocator(size, &heap_allocator);
+}
+
+vector_t *vector_t_create_with_allocator(const size_t size, const allocator_t *allocator)
+{
+  vector_t *v = NULL;
+  vector_t_init_with_allocator(&v, allocator);
+
+  if (v == NULL)
+    return NULL;
+
+  if (size > 0)
+    vector_t_resize(v, size);
+
+  if (v->size != size)
+  {
+    vector_t_destroy(v);
+    return NULL;
+  }
+
+  return v;
+}
+
+vector_t *vector_t_create_sized(const size_t width, const size_t size)
+{
+  return vector_t_create_sized_with_allocator(width, size, &heap_allocator);
+}
+
+vector_t *vector_t_create_sized_with_allocator(const size_t width, const size_t size, const allocator_t *allocator)
+{
+  vector_t *v = NULL;
+  vector_t_init_with_allocator(&v, allocator);
+
+  if (v == NULL)
+    return NULL;
+
+  v->width = width;
+
+  if (size > 0)
+    vector_t_resize(v, size);
+
+  if (v->size != size)
+  {
+    vector_t_destroy(v);
+    return NULL;
+  }
+
+  return v;
+}
+
+vector_t *vector_t_open_mmap(const char *path, const size_t width)
+{
+  if (path == NULL || width == 0)
+    return NULL;
+
+  int fd = open(path, O_RDWR | O_CREAT, 0644);
+  struct stat st;
+  vector_t_map_header header = {VECTOR_T_MAP_MAGIC, VECTOR_T_MAP_VERSION, width, 0};
+
+  if (fd < 0)
+    return NULL;
+
+  size_t bytes = fstat(fd, &st) == 0 ? (size_t)st.st_size : 0;
+  size_t capacity = bytes > VECTOR_T_MAP_HEADER ? (bytes - VECTOR_T_MAP_HEADER) / width : 0;
+
+  // existing files must hold a vector of `width` members, they are left untouched otherwise
+  if (bytes > 0 && (bytes < VECTOR_T_MAP_HEADER || pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+                    memcmp(header.magic, VECTOR_T_MAP_MAGIC, sizeof(header.magic)) != 0 ||
+                    header.version != VECTOR_T_MAP_VERSION || header.width != width || header.size > capacity))
+  {
+    close(fd);
+    return NULL;
+  }
+
+  vector_t *v = vector_t_create_sized(width, 0);
+
+  if (v == NULL || vector_t_ext_own(v) == NULL)
+  {
+    vector_t_destroy(v);
+    close(fd);
+    return NULL;
+  }
+
+  v->extension->fd = fd;
+
+  if (vector_t_map(v, capacity > 4 ? capacity : 4) != 0)
+  {
+    v->extension->fd = -1;
+    vector_t_destroy(v);
+    close(fd);
+    return NULL;
+  }
+
+  memcpy(vector_t_map_base(v), &header, sizeof(header));
+  v->size = header.size;
+  v->length = v->size;
+
+  return v;
+}
+
+int vector_t_sync(vector_t *v)
+{
+  if (v == NULL || vector_t_ext(v)->fd < 0)
+    return -1;
+
+  vector_t_map_size(v);
+
+  return msync(vector_t_map_base(v), v->extension->mapped, MS_SYNC);
+}
+
+int vector_t_save(vector_t *v, const char *path)
+{
+  if (v == NULL || path == NULL || v->width == 0)
+    return -1;
+
+  vector_t_flat(v);
+
+  vector_io_header header = {.width = v->width, .count = v->size};
+
+  return vector_io_save(path, &header, v->items, v->size);
+}
+
+vector_t *vector_t_load(const char *path)
+{
+  vector_io_header header;
+  int fd = vector_io_open(path, &header);
+
+  if (fd < 0)
+    return NULL;
+
+  // one read straight into the buffer sized for all members
+  vector_t *v = vector_t_create_sized(header.width, header.count);
+
+  if (v != NULL && vector_io_read(fd, v->items, header.count * header.width) != 0)
+  {
+    vector_t_destroy(v);
+    v = NULL;
+  }
+
+  close(fd);
+
+  return v;
+}
+
+vector_t_reader *vector_t_reader_open(const char *path)
+{
+  vector_t_reader *reader = malloc_realloc(sizeof(vector_t_reader), NULL);
+
+  if (reader == NULL)
+    return NULL;
+
+  reader->fd = vector_io_open(path, &reader->header);
+  reader->read = 0;
+
+  if (reader->fd < 0)
+  {
+    heap_free(reader);
+    return NULL;
+  }
+
+  return reader;
+}
+
+size_t vector_t_reader_width(const vector_t_reader *reader)
+{
+  return reader->header.width;
+}
+
+size_t vector_t_reader_count(const vector_t_reader *reader)
+{
+  return reader->header.count;
+}
+
+size_t vector_t_reader_read(vector_t_reader *reader, void *buffer, size_t count)
+{
+  if (count > reader->header.count - reader->read)
+    count = reader->header.count - reader->read;
+
+  if (count == 0 || vector_io_read(reader->fd, buffer, count * reader->header.width) != 0)
+    return 0;
+
+  reader->read += count;
+
+  return count;
+}
+
+void vector_t_reader_close(vector_t_reader *reader)
+{
+  if (reader == NULL)
+    return;
+
+  close(reader->fd);
+  heap_free(reader);
+}
+
+void vector_t_destroy(vector_t *v)
+{
+  if (v == NULL)
+    return;
+
+  vector_t_extension *e = v->extension;
+
+  if (e != NULL && e->fd >= 0)
+  {
+    vector_t_map_size(v);
+    munmap(vector_t_map_base(v), e->mapped);
+    close(e->fd);
+  }
+  else if (e != NULL && e->shared != NULL)
+  {
+    if (__atomic_sub_fetch(e->shared, 1, __ATOMIC_ACQ_REL) == 0)
+    {
+      vector_t_heap_free(v, v->items, v->capacity, e->aligned);
+      v->allocator->free(e->shared, sizeof(size_t), v->allocator->context);
+    }
+  }
+  else
+  {
+    vector_t_release(v);
+  }
+
+  if (v->bits != NULL)
+    v->allocator->free(v->bits, vector_t_bits_bytes(v->capacity), v->allocator->context);
+
+  if (e != NULL)
+    v->allocator->free(e, sizeof(*e), v->allocator->context);
+
+  v->allocator->free(v, sizeof(*v), v->allocator->context);
+}
+
+int vector_t_reserve(vector_t *v, const size_t capacity)
+{
+  if (v == NULL)
+    return -1;
+
+  if (capacity <= v->capacity)
+    return 0;
+
+  // the buffer, and the file of mapped vectors, must be addressable in bytes
+  if (capacity > (SIZE_MAX - VECTOR_T_MAP_HEADER) / vector_t_bytes(v, 1))
+    return -1;
+
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return -1;
+
+  if (vector_t_ext(v)->fd >= 0)
+  {
+    if (vector_t_map(v, capacity) != 0)
+      return -1;
+
+    VECTOR_T_COUNT(grows, 1);
+    return 0;
+  }
+
+  if (vector_t_small_fits(v, capacity) && (v->items == NULL || vector_t_small(v)))
+    v->items = v->small.items;
+  else if (vector_t_realloc(v, capacity) != 0)
+    return -1;
+
+  if (v->bits != NULL)
+  {
+    size_t bytes = vector_t_bits_bytes(v->capacity);
+    v->bits = v->allocator->realloc(v->bits, bytes, vector_t_bits_bytes(capacity), v->allocator->context);
+    memset((char *)v->bits + bytes, 0, vector_t_bits_bytes(capacity) - bytes);
+  }
+
+  v->capacity = capacity;
+  VECTOR_T_COUNT(grows, 1);
+
+  return 0;
+}
+
+void vector_t_shrink_to_fit(vector_t *v)
+{
+  if (v == NULL || v->capacity == v->size)
+    return;
+
+  vector_t_flat(v);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  if (vector_t_ext(v)->fd >= 0)
+  {
+    vector_t_map(v, v->size);
+    return;
+  }
+
+  if (vector_t_small(v))
+  {
+    if (v->size == 0)
+      v->items = NULL;
+  }
+  else if (v->size == 0)
+  {
+    vector_t_release(v);
+    v->items = NULL;
+  }
+  else if (vector_t_small_fits(v, v->size))
+  {
+    memcpy(v->small.items, v->items, vector_t_bytes(v, v->size));
+    vector_t_release(v);
+    v->items = v->small.items;
+  }
+  else if (vector_t_realloc(v, v->size) != 0)
+  {
+    // the larger buffer is kept
+    return;
+  }
+
+  if (v->bits != NULL)
+    v->bits = v->allocator->realloc(v->bits, vector_t_bits_bytes(v->capacity), vector_t_bits_bytes(v->size),
+                                    v->allocator->context);
+
+  v->capacity = v->size;
+}
+
+void vector_t_resize(vector_t *v, const size_t size)
+{
+  if (v == NULL)
+    return;
+
+  VECTOR_T_COUNT(resizes, 1);
+
+  vector_t_flat(v);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  if (size > v->size)
+  {
+    if (vector_t_reserve(v, size) == 0)
+      vector_t_extend(v, size);
+
+    return;
+  }
+
+  v->size = size;
+
+  if (v->length > size)
+  {
+    vector_t_bits_fill(v, size, v->length, 0);
+    v->length = size;
+
+    if (v->width == 0)
+      vector_t_trim(v);
+  }
+}
+
+size_t vector_t_compact(vector_t *v)
+{
+  if (v == NULL || v->items == NULL)
+    return 0;
+
+  vector_t_flat(v);
+
+  // sized vectors have no empty positions
+  if (v->width > 0)
+    return v->size;
+
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return v->length;
+
+  VECTOR_T_COUNT(scanned, v->length);
+
+  size_t cursor = 0;
+
+  if (v->bits != NULL)
+  {
+    // visit only occupied slots, skipping empty words entirely
+    for (size_t word = 0; word < VECTOR_T_WORDS(v->length); word++)
+    {
+      for (uint64_t w = v->bits[word]; w != 0; w &= w - 1)
+        v->items[cursor++] = v->items[word * VECTOR_T_WORD_BITS + __builtin_ctzll(w)];
+    }
+  }
+  else
+  {
+    cursor = vector_simd_compact(v->items, v->length);
+  }
+
+  memset(&v->items[cursor], 0, (v->length - cursor) * sizeof(void *));
+
+  vector_t_bits_fill(v, 0, cursor, 1);
+  vector_t_bits_fill(v, cursor, v->length, 0);
+  v->length = cursor;
+
+  return cursor;
+}
+
+/**
+ * @brief sized vectors always shift right, making room at `index`
+ */
+static void vector_t_insert_sized(vector_t *v, const size_t index, void *item)
+{
+  if (index >= v->size)
+  {
+    if (vector_t_extend(v, index + 1) != 0)
+      return;
+  }
+  else
+  {
+    if (vector_t_grow(v, v->size + 1) != 0)
+      return;
+
+    vector_t_shift_bytes(vector_t_at(v, index + 1), vector_t_at(v, index), (v->size - index) * v->width);
+    v->size++;
+    v->length++;
+  }
+
+  if (item != NULL)
+    memcpy(vector_t_at(v, index), item, v->width);
+  else
+    memset(vector_t_at(v, index), 0, v->width);
+}
+
+void vector_t_insert(vector_t *v, const size_t index, void *item)
+{
+  if (v == NULL)
+    return;
+
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  if (vector_t_ext(v)->gap)
+  {
+    if (vector_t_gap_insert(v, index, item))
+      return;
+
+    vector_t_flat(v);
+  }
+
+  if (v->width > 0)
+  {
+    vector_t_insert_sized(v, index, item);
+    return;
+  }
+
+  if (index >= v->size)
+  {
+    if (vector_t_extend(v, index + 1) != 0)
+      return;
+  }
+  else if (v->items[index] == NULL)
+  {
+    // free position, nothing to move
+    v->items[index] = item;
+
+    if (item != NULL)
+    {
+      if (v->bits != NULL)
+        vector_t_bit(v, index, 1);
+
+      if (index >= v->length)
+        v->length = index + 1;
+    }
+
+    return;
+  }
+  else
+  {
+    // last slot is taken, so the shift needs one more
+    if (v->length == v->size && vector_t_extend(v, v->size + 1) != 0)
+      return;
+
+    // everything after `length` is NULL, no need to move it
+    vector_t_shift_bytes(&v->items[index + 1], &v->items[index], (v->length - index) * sizeof(void *));
+    v->length++;
+    vector_t_bits_refresh(v, index + 1, v->length);
+  }
+
+  v->items[index] = item;
+  vector_t_track(v, index);
+}
+
+void vector_t_set(vector_t *v, const size_t index, void *item)
+{
+  if (v == NULL)
+    return;
+
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  if (vector_t_ext(v)->gapped)
+  {
+    if (index < v->extension->stored)
+    {
+      vector_t_gap_set(v, index, item);
+      return;
+    }
+
+    vector_t_flat(v);
+  }
+
+  if (index >= v->size && vector_t_extend(v, index + 1) != 0)
+    return;
+
+  if (v->width > 0)
+  {
+    if (item != NULL)
+      memcpy(vector_t_at(v, index), item, v->width);
+    else
+      memset(vector_t_at(v, index), 0, v->width);
+
+    return;
+  }
+
+  v->items[index] = item;
+  vector_t_track(v, index);
+}
+
+/**
+ * @brief sized vectors have no empty positions, removing shrinks the size
+ */
+static void vector_t_remove_sized(vector_t *v, size_t index, const size_t count)
+{
+  size_t tail = v->size - index;
+  size_t removed = count < tail ? count : tail;
+
+  vector_t_shift_bytes(vector_t_at(v, index), vector_t_at(v, index + removed), (tail - removed) * v->width);
+
+  v->size -= removed;
+  v->length = v->size;
+}
+
+void vector_t_remove(vector_t *v, size_t index, const size_t count)
+{
+  // everything after `length` is already NULL
+  if (v->items == NULL || index >= v->length || count == 0)
+    return;
+
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  if (vector_t_ext(v)->gap)
+  {
+    vector_t_gap_remove(v, index, count);
+    return;
+  }
+
+  if (v->width > 0)
+  {
+    vector_t_remove_sized(v, index, count);
+    return;
+  }
+
+  size_t tail = v->length - index;
+
+  if (count < tail)
+  {
+    // size:= 10, length := 8, index:= 5, count := 2
+    // v[5..6] = v[7..8], v[6..8] = NULL
+    vector_t_shift_bytes(&v->items[index], &v->items[index + count], (tail - count) * sizeof(void *));
+
+    for (size_t i = v->length - count; i < v->length; i++)
+      v->items[i] = NULL;
+
+    vector_t_bits_refresh(v, index, v->length - count);
+    vector_t_bits_fill(v, v->length - count, v->length, 0);
+    v->length -= count;
+  }
+  else
+  {
+    for (size_t i = index; i < v->length; i++)
+      v->items[i] = NULL;
+
+    vector_t_bits_fill(v, index, v->length, 0);
+    v->length = index;
+    vector_t_trim(v);
+  }
+}
+
+void vector_t_push(vector_t *v, void *item)
+{
+  VECTOR_T_COUNT(pushes, 1);
+  vector_t_flat(v);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  if (v->length == v->size)
+  {
+    if (v->size == v->capacity && vector_t_grow(v, v->size + 1) != 0)
+      return;
+
+    v->size++;
+  }
+
+  if (v->width > 0)
+  {
+    if (item != NULL)
+      memcpy(vector_t_at(v, v->length), item, v->width);
+    else
+      memset(vector_t_at(v, v->length), 0, v->width);
+
+    v->length++;
+    return;
+  }
+
+  v->items[v->length] = item;
+
+  if (item != NULL)
+  {
+    if (v->bits != NULL)
+      vector_t_bit(v, v->length, 1);
+
+    v->length++;
+  }
+}
+
+void vector_t_push_n(vector_t *v, void *items, const size_t count)
+{
+  if (v == NULL || count == 0)
+    return;
+
+  vector_t_flat(v);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  size_t index = v->length;
+
+  if (index + count > v->size && vector_t_extend(v, index + count) != 0)
+    return;
+
+  memcpy(vector_t_slot(v, index), items, vector_t_bytes(v, count));
+
+  if (v->width == 0)
+  {
+    vector_t_bits_refresh(v, index, index + count);
+    v->length = index + count;
+    vector_t_trim(v);
+  }
+}
+
+void vector_t_insert_range(vector_t *v, const size_t index, void *items, const size_t count)
+{
+  if (v == NULL || count == 0)
+    return;
+
+  vector_t_flat(v);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  // nothing to shift after `length`, positions are free
+  if (index >= v->length)
+  {
+    if (index + count > v->size && vector_t_extend(v, index + count) != 0)
+      return;
+
+    memcpy(vector_t_slot(v, index), items, vector_t_bytes(v, count));
+
+    if (v->width == 0)
+    {
+      vector_t_bits_refresh(v, index, index + count);
+      v->length = index + count;
+      vector_t_trim(v);
+    }
+
+    return;
+  }
+
+  size_t length = v->length;
+
+  if (length + count > v->size && vector_t_extend(v, length + count) != 0)
+    return;
+
+  // a single move of the tail, then a single copy
+  vector_t_shift_bytes(vector_t_slot(v, index + count), vector_t_slot(v, index), vector_t_bytes(v, length - index));
+  memcpy(vector_t_slot(v, index), items, vector_t_bytes(v, count));
+
+  v->length = v->width > 0 ? v->size : length + count;
+
+  if (v->width == 0)
+    vector_t_bits_refresh(v, index, v->length);
+}
+
+void vector_t_append_vector(vector_t *v, vector_t *other)
+{
+  if (v == NULL || other == NULL || v->width != other->width)
+    return;
+
+  vector_t_flat(v);
+  vector_t_flat(other);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  size_t count = other->length;
+
+  // grow first, `other` may be `v` itself
+  if (vector_t_grow(v, v->length + count) != 0)
+    return;
+
+  vector_t_push_n(v, other->items, count);
+}
+
+void *vector_t_get(const vector_t *vector, const size_t index)
+{
+  if (vector->items == NULL || index >= vector->size)
+    return NULL;
+
+  if (vector_t_ext(vector)->gapped)
+  {
+    if (index >= vector->extension->stored)
+      return NULL;
+
+    size_t slot = vector_t_gap_slot(vector, index);
+    return vector->width > 0 ? vector_t_slot(vector, slot) : vector->items[slot];
+  }
+
+  if (vector->width > 0)
+    return vector_t_at(vector, index);
+
+  return vector->items[index];
+}
+
+size_t vector_t_size(const vector_t *vector)
+{
+  return vector->size;
+}
+
+size_t vector_t_length(const vector_t *vector)
+{
+  return vector->length;
+}
+
+size_t vector_t_capacity(const vector_t *vector)
+{
+  return vector->capacity;
+}
+
+size_t vector_t_element_size(const vector_t *vector)
+{
+  return vector->width;
+}
+
+void vector_t_move(vector_t *v, const size_t origin, const size_t destination)
+{
+  if (v == NULL || v->items == NULL || origin >= v->size)
+    return;
+
+  vector_t_flat(v);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  if (destination >= v->size && vector_t_extend(v, destination + 1) != 0)
+    return;
+
+  if (v->width > 0)
   {
-    vector_t_resize(v, size);
-    v->size = size;
+    if (origin == destination)
+      return;
+
+    memcpy(vector_t_at(v, destination), vector_t_at(v, origin), v->width);
+    memset(vector_t_at(v, origin), 0, v->width);
+    return;
   }
 
-  return v;
+  v->items[destination] = v->items[origin];
+  v->items[origin] = NULL;
+
+  vector_t_track(v, destination);
+  vector_t_track(v, origin);
 }
 
-void vector_t_destroy(vector_t *v)
+void vector_t_swap(vector_t *v, size_t idx1, size_t idx2)
 {
-  if (v == NULL)
+  if (v == NULL || v->items == NULL)
     return;
 
-  if (v->items != NULL)
-    free(v->items);
+  vector_t_flat(v);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
 
-  free(v);
-}
+  if ((idx1 >= v->size || idx2 >= v->size) && vector_t_extend(v, (idx1 > idx2 ? idx1 : idx2) + 1) != 0)
+    return;
 
-void vector_t_resize(vector_t *v, const size_t size)
-{
-  if (v == NULL)
-    vector_t_init(&v);
+  if (idx1 == idx2)
+    return;
 
-  v->items = malloc_realloc(sizeof(void *) * size, v->items);
+  if (v->width > 0)
+  {
+    vector_t_swap_bytes(vector_t_at(v, idx1), vector_t_at(v, idx2), v->width);
+    return;
+  }
 
-  for (size_t i = v->size; i < size; i++)
-    v->items[i] = NULL;
+  void *t = v->items[idx1];
+  v->items[idx1] = v->items[idx2];
+  v->items[idx2] = t;
 
-  v->size = size;
+  // track the higher index last, it may trim past the lower one
+  vector_t_track(v, idx1 < idx2 ? idx1 : idx2);
+  vector_t_track(v, idx1 < idx2 ? idx2 : idx1);
 }
 
-size_t vector_t_compact(vector_t *v)
+/**
+ * @brief single pass of `vector_t_remove_if` (`matching` set) and `vector_t_retain`
+ */
+static size_t vector_t_filter(vector_t *v, vector_t_predicate predicate, void *context, const int matching)
 {
   if (v == NULL || v->items == NULL)
     return 0;
 
+  vector_t_flat(v);
+
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return 0;
+
+  VECTOR_T_COUNT(scanned, v->width > 0 ? v->size : v->length);
+
   size_t cursor = 0;
 
-  for (size_t i = 0; i < v->size; i++)
+  if (v->width > 0)
   {
-    if (v->items[i] != NULL)
+    for (size_t i = 0; i < v->size; i++)
     {
-      v->items[cursor] = v->items[i];
+      if ((predicate(vector_t_at(v, i), context) != 0) == matching)
+        continue;
+
+      if (cursor != i)
+        memcpy(vector_t_at(v, cursor), vector_t_at(v, i), v->width);
+
       cursor++;
     }
+
+    size_t removed = v->size - cursor;
+    v->size = cursor;
+    v->length = cursor;
+
+    return removed;
   }
 
-  for (size_t i = cursor; i < v->size; i++)
-    v->items[i] = NULL;
+  size_t length = v->length;
 
-  return cursor;
+  for (size_t i = 0; i < length; i++)
+  {
+    void *item = v->items[i];
+
+    if (item != NULL && (predicate(item, context) != 0) == matching)
+      continue;
+
+    v->items[cursor++] = item;
+  }
+
+  memset(&v->items[cursor], 0, (length - cursor) * sizeof(void *));
+
+  vector_t_bits_refresh(v, 0, cursor);
+  vector_t_bits_fill(v, cursor, length, 0);
+  v->length = cursor;
+  vector_t_trim(v);
+
+  return length - cursor;
 }
 
-void vector_t_insert(vector_t *v, const size_t index, void *item)
+size_t vector_t_remove_if(vector_t *v, vector_t_predicate predicate, void *context)
 {
-  if (v == NULL || v->items == NULL)
-    vector_t_resize(v, index);
+  return vector_t_filter(v, predicate, context, 1);
+}
 
-  if (index >= v->size)
+size_t vector_t_retain(vector_t *v, vector_t_predicate predicate, void *context)
+{
+  return vector_t_filter(v, predicate, context, 0);
+}
+
+vector_t *vector_t_copy(vector_t *o)
+{
+  vector_t_flat(o);
+
+  const vector_t_extension *e = vector_t_ext(o);
+  vector_t *v = vector_t_create_sized_with_allocator(o->width, 0, o->allocator);
+
+  if (v == NULL)
+    return NULL;
+
+  // the copy keeps the alignment and huge pages of `o`, it has an extension when `o` needs one
+  if ((e->alignment > 0 || e->huge) && vector_t_ext_own(v) == NULL)
   {
-    vector_t_resize(v, index + 1);
+    vector_t_destroy(v);
+    return NULL;
   }
-  else
+
+  if (v->extension != NULL)
   {
-    if (v->items[index] != NULL)
-    {
-      if (v->items[v->size - 1] != NULL)
-        vector_t_resize(v, v->size + 1);
+    v->extension->alignment = e->alignment;
+    v->extension->huge = e->huge;
+  }
+
+  // inline and mapped buffers can not be freed as shared heap ones, they are copied right away
+  if (o->items == NULL || vector_t_small(o) || e->fd >= 0 || e->huge_mapped > 0)
+  {
+    vector_t_resize(v, o->size);
+
+    if (o->length > 0)
+      memcpy(v->items, o->items, vector_t_bytes(o, o->length));
+
+    v->length = o->length;
+
+    if (o->bits != NULL)
+      vector_t_bitmap(v, 1);
+
+    return v;
+  }
+
+  if (vector_t_ext_own(o) == NULL || vector_t_ext_own(v) == NULL)
+  {
+    vector_t_destroy(v);
+    return NULL;
+  }
+
+  if (o->extension->shared == NULL)
+  {
+    o->extension->shared = o->allocator->alloc(sizeof(size_t), o->allocator->context);
 
-      memmove(&v->items[index + 1], &v->items[index], (v->size - index) * sizeof(void *));
+    if (o->extension->shared == NULL)
+    {
+      vector_t_destroy(v);
+      return NULL;
     }
+
+    *o->extension->shared = 1;
   }
 
-  v->items[index] = item;
-}
+  __atomic_add_fetch(o->extension->shared, 1, __ATOMIC_RELAXED);
 
-void vector_t_set(vector_t *v, const size_t index, void *item)
-{
-  if (v == NULL || v->items == NULL || index >= v->size)
-    vector_t_resize(v, index + 1);
+  v->items = o->items;
+  v->extension->shared = o->extension->shared;
+  v->extension->aligned = o->extension->aligned;
+  v->size = o->size;
+  v->length = o->length;
+  v->capacity = o->capacity;
 
-  v->items[index] = item;
+  if (o->bits != NULL)
+  {
+    size_t bytes = vector_t_bits_bytes(o->capacity);
+    v->bits = o->allocator->alloc(bytes, o->allocator->context);
+    memcpy(v->bits, o->bits, bytes);
+  }
+
+  return v;
 }
 
-void vector_t_remove(vector_t *v, size_t index, const size_t count)
+void vector_t_reverse(vector_t *v)
 {
-  if (v->items == NULL || index >= v->size)
+  vector_t_flat(v);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  if (v->width > 0)
+  {
+    for (size_t i = 0; i < v->size / 2; i++)
+      vector_t_swap_bytes(vector_t_at(v, i), vector_t_at(v, v->size - 1 - i), v->width);
+
     return;
+  }
+
+  void *t = NULL;
+  size_t first = 0;
 
-  // size:= 10, index:= 7, count := 1
-  // 7; 7 < 10 -> v[7] = v[8]
-  // 8; 8 < 10 -> v[8] = v[9]
-  // 9; 9 < 10 -> v[9] = NULL
+  while (first < v->length && v->items[first] == NULL)
+    first++;
 
-  // size:= 10, index:= 5, count := 2
-  // 5; 5 < 10 -> v[5] = v[7]
-  // 6; 6 < 10 -> v[6] = v[8]
-  // 7; 7 < 10 -> v[7] = v[9]
-  // 8; 8 < 10 -> v[8] = NULL
-  // 9; 9 < 10 -> v[9] = NULL
-  for (; index < v->size; index++)
-    v->items[index] = index + count < v->size
-                          ? v->items[index + count]
-                          : NULL;
+  for (size_t i = 0; i < (size_t)v->size / 2; i++)
+  {
+    t = v->items[i];
+    v->items[i] = v->items[v->size - 1 - i];
+    v->items[v->size - 1 - i] = t;
+  }
+
+  v->length = v->length > 0 ? v->size - first : 0;
+  vector_t_bits_refresh(v, 0, v->size);
 }
 
-void vector_t_push(vector_t *v, void *item)
+void vector_t_clean(vector_t *v)
 {
-  size_t i = v->size - 1;
+  if (v == NULL || v->items == NULL)
+    return;
 
-  for (; i >= 0; i--)
-    if (v->items[i] != NULL)
-      break;
+  vector_t_flat(v);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
 
-  i++;
+  if (v->width > 0)
+  {
+    memset(v->items, 0, v->size * v->width);
+    return;
+  }
 
-  if (i == v->size)
-    vector_t_resize(v, i + 1);
+  memset(v->items, 0, v->length * sizeof(void *));
 
-  v->items[i] = item;
+  vector_t_bits_fill(v, 0, v->length, 0);
+  v->length = 0;
 }
 
-void *vector_t_get(const vector_t *vector, const size_t index)
+void vector_t_bitmap(vector_t *v, const int enabled)
 {
-  if (vector->items == NULL || index >= vector->size)
-    return NULL;
+  if (v == NULL || v->width > 0 || vector_t_ext(v)->gap)
+    return;
 
-  return vector->items[index];
+  if (!enabled)
+  {
+    if (v->bits != NULL)
+      v->allocator->free(v->bits, vector_t_bits_bytes(v->capacity), v->allocator->context);
+
+    v->bits = NULL;
+    return;
+  }
+
+  if (v->bits != NULL)
+    return;
+
+  v->bits = v->allocator->alloc(vector_t_bits_bytes(v->capacity), v->allocator->context);
+  memset(v->bits, 0, vector_t_bits_bytes(v->capacity));
+  vector_t_bits_refresh(v, 0, v->length);
 }
 
-size_t vector_t_size(const vector_t *vector)
+int vector_t_align(vector_t *v, const size_t alignment)
 {
-  return vector->size;
+  if (v == NULL || vector_t_ext(v)->fd >= 0 || (alignment & (alignment - 1)) != 0)
+    return -1;
+
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return -1;
+
+  vector_t_extension *e = vector_t_ext_own(v);
+
+  if (e == NULL)
+    return -1;
+
+  size_t previous = e->alignment;
+  e->alignment = alignment > 0 && alignment < sizeof(void *) ? sizeof(void *) : alignment;
+
+  if (v->items != NULL && e->alignment > 0 && (uintptr_t)v->items % e->alignment != 0 &&
+      vector_t_realloc(v, v->capacity) != 0)
+  {
+    e->alignment = previous;
+    return -1;
+  }
+
+  return 0;
 }
 
-void vector_t_move(vector_t *v, const size_t origin, const size_t destination)
+int vector_t_huge_pages(vector_t *v, const int enabled)
 {
-  if (v == NULL || v->items == NULL || origin >= v->size)
-    return;
+  if (v == NULL || vector_t_ext(v)->fd >= 0)
+    return -1;
 
-  if (destination >= v->size)
-    vector_t_resize(v, destination + 1);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return -1;
 
-  v->items[destination] = v->items[origin];
-  v->items[origin] = NULL;
+  vector_t_extension *e = vector_t_ext_own(v);
+
+  if (e == NULL)
+    return -1;
+
+  int previous = e->huge;
+  e->huge = enabled != 0;
+
+  // moves the current buffer in or out of a mapping right away
+  int mapped = e->huge && vector_t_bytes(v, v->capacity) >= HEAP_HUGE_THRESHOLD;
+
+  if (v->items != NULL && !vector_t_small(v) && mapped != (e->huge_mapped > 0) &&
+      vector_t_realloc(v, v->capacity) != 0)
+  {
+    e->huge = previous;
+    return -1;
+  }
+
+  return 0;
 }
 
-void vector_t_swap(vector_t *v, size_t idx1, size_t idx2)
+void vector_t_stats(vector_t_stats_t *stats)
 {
-  if (v == NULL || v->items == NULL)
+#ifdef VECTOR_STATS
+  stats->resizes = __atomic_load_n(&vector_t_counters.resizes, __ATOMIC_RELAXED);
+  stats->grows = __atomic_load_n(&vector_t_counters.grows, __ATOMIC_RELAXED);
+  stats->moved = __atomic_load_n(&vector_t_counters.moved, __ATOMIC_RELAXED);
+  stats->pushes = __atomic_load_n(&vector_t_counters.pushes, __ATOMIC_RELAXED);
+  stats->scanned = __atomic_load_n(&vector_t_counters.scanned, __ATOMIC_RELAXED);
+#else
+  memset(stats, 0, sizeof(*stats));
+#endif
+}
+
+void vector_t_gap_buffer(vector_t *v, const int enabled)
+{
+  if (v == NULL)
     return;
 
-  if (idx1 >= v->size || idx2 >= v->size)
-    vector_t_resize(v, (idx1 > idx2 ? idx1 : idx2) + 1);
+  if (enabled)
+  {
+    // without room for the extension the vector stays flat
+    if (vector_t_ext_own(v) == NULL)
+      return;
 
-  if (idx1 == idx2)
+    // positions move with the gap, the bitmap would need shifting on each edit
+    vector_t_bitmap(v, 0);
+    v->extension->gap = 1;
     return;
+  }
 
-  void *t = v->items[idx1];
-  v->items[idx1] = v->items[idx2];
-  v->items[idx2] = t;
+  vector_t_flat(v);
+
+  if (v->extension != NULL)
+    v->extension->gap = 0;
 }
 
-vector_t *vector_t_copy(const vector_t *o)
+size_t vector_t_count(const vector_t *v)
 {
-  vector_t *v = vector_t_create(o->size);
-  memcpy(v->items, o->items, v->size * sizeof(void *));
-  return v;
+  if (v->width > 0)
+    return v->size;
+
+  // gap buffer vectors have no bitmap, both sides of the gap are counted in place
+  if (vector_t_ext(v)->gapped)
+  {
+    const vector_t_extension *e = v->extension;
+
+    return vector_simd_count(v->items, e->gap_start) +
+           vector_simd_count(&v->items[e->gap_start + e->gap_length], e->stored - e->gap_start);
+  }
+
+  size_t count = 0;
+
+  if (v->bits != NULL)
+  {
+    for (size_t word = 0; word < VECTOR_T_WORDS(v->length); word++)
+      count += __builtin_popcountll(v->bits[word]);
+
+    return count;
+  }
+
+  return vector_simd_count(v->items, v->length);
 }
 
-void vector_t_reverse(vector_t *v)
+size_t vector_t_first_free(const vector_t *v)
 {
-  void *t = NULL;
+  if (v->width > 0)
+    return v->size;
 
-  for (size_t i = 0; i < (size_t)v->size / 2; i++)
+  // positions past `length` are free, only the ones before it are looked at on both sides of the gap
+  if (vector_t_ext(v)->gapped)
   {
-    t = v->items[i];
-    v->items[i] = v->items[v->size - 1 - i];
-    v->items[v->size - 1 - i] = t;
+    const vector_t_extension *e = v->extension;
+    size_t before = v->length < e->gap_start ? v->length : e->gap_start;
+    size_t index = vector_simd_first_null(v->items, before);
+
+    if (index == before && v->length > e->gap_start)
+      index += vector_simd_first_null(&v->items[e->gap_start + e->gap_length], v->length - e->gap_start);
+
+    VECTOR_T_COUNT(scanned, index < v->length ? index + 1 : v->length);
+    return index;
+  }
+
+  if (v->bits != NULL)
+  {
+    for (size_t word = 0; word < VECTOR_T_WORDS(v->length); word++)
+    {
+      if (v->bits[word] != ~(uint64_t)0)
+      {
+        size_t index = word * VECTOR_T_WORD_BITS + __builtin_ctzll(~v->bits[word]);
+        VECTOR_T_COUNT(scanned, index < v->length ? index + 1 : v->length);
+        return index < v->size ? index : v->size;
+      }
+    }
+
+    VECTOR_T_COUNT(scanned, v->length);
+    return v->length;
   }
+
+  size_t index = vector_simd_first_null(v->items, v->length);
+  VECTOR_T_COUNT(scanned, index < v->length ? index + 1 : v->length);
+
+  return index;
 }
 
-void vector_t_clean(vector_t *v)
+void vector_t_sort(vector_t *v, vector_t_compare compare)
 {
   if (v == NULL || v->items == NULL)
     return;
 
-  for (size_t i = 0; i < v->size; i++)
+  vector_t_flat(v);
+  if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+    return;
+
+  if (v->width == 0)
+  {
+    // NULLs go to the end, as `vector_t_compact`
+    vector_sort_pointers(v->items, vector_t_compact(v), compare);
+    return;
+  }
+
+  // sort addresses of the members, then lay the members out in that order
+  const allocator_t *allocator = v->allocator;
+  void **order = allocator->alloc(sizeof(void *) * v->size, allocator->context);
+  char *sorted = allocator->alloc(v->size * v->width, allocator->context);
+
+  if (order != NULL && sorted != NULL)
+  {
+    for (size_t i = 0; i < v->size; i++)
+      order[i] = vector_t_at(v, i);
+
+    if (vector_sort_pointers(order, v->size, compare) == 0)
+    {
+      for (size_t i = 0; i < v->size; i++)
+        memcpy(&sorted[i * v->width], order[i], v->width);
+
+      memcpy(v->items, sorted, v->size * v->width);
+    }
+  }
+
+  if (order != NULL)
+    allocator->free(order, sizeof(void *) * v->size, allocator->context);
+
+  if (sorted != NULL)
+    allocator->free(sorted, v->size * v->width, allocator->context);
+}
+
+size_t vector_t_lower_bound(const vector_t *v, const void *key, vector_t_compare compare)
+{
+  size_t low = 0;
+  size_t high = v->length;
+
+  while (low < high)
   {
-    v->items[i] = NULL;
+    size_t middle = low + (high - low) / 2;
+
+    if (compare(vector_t_get(v, middle), key) < 0)
+      low = middle + 1;
+    else
+      high = middle;
   }
+
+  return low;
+}
+
+void *vector_t_bsearch(const vector_t *v, const void *key, vector_t_compare compare)
+{
+  size_t index = vector_t_lower_bound(v, key, compare);
+
+  if (index < v->length && compare(vector_t_get(v, index), key) == 0)
+    return vector_t_get(v, index);
+
+  return NULL;
+}
+
+void vector_t_iterator_init_range(vector_t_iterator *iter, vector_t *vector, const size_t from, const size_t to)
+{
+  iter->vector = vector;
+  iter->begin = from;
+  iter->end = to;
+  iter->reverse = 0;
+  iter->cursor = from;
+}
+
+void vector_t_iterator_init(vector_t_iterator *iter, vector_t *vector)
+{
+  // follows the size of the vector, even if it changes
+  vector_t_iterator_init_range(iter, vector, 0, (size_t)-1);
+}
+
+void vector_t_iterator_init_reverse(vector_t_iterator *iter, vector_t *vector)
+{
+  vector_t_iterator_init_range(iter, vector, 0, vector->size);
+  iter->reverse = 1;
+
+  // in reverse, `cursor` is right after the next position
+  iter->cursor = iter->end;
 }
 
 vector_t_iterator *vector_t_iterator_create(vector_t *vector)
 {
   vector_t_iterator *iter = malloc_realloc(sizeof(vector_t_iterator), NULL);
-  iter->cursor = 0;
-  iter->vector = vector;
+  vector_t_iterator_init(iter, vector);
   return iter;
 }
 
 void vector_t_iterator_destroy(vector_t_iterator *iter)
 {
-  free(iter);
+  heap_free(iter);
 }
 
 size_t vector_t_iterator_cursor(vector_t_iterator *iter)
 {
-  return iter->cursor == 0 ? 0 : iter->cursor - 1;
+  if (iter->reverse)
+    return iter->cursor;
+
+  return iter->cursor == iter->begin ? iter->begin : iter->cursor - 1;
+}
+
+int vector_t_iterator_has_next(const vector_t_iterator *iter)
+{
+  if (iter->reverse)
+    return iter->cursor > iter->begin && iter->cursor <= iter->vector->size;
+
+  return iter->cursor < iter->end && iter->cursor < iter->vector->size;
 }
 
 void *vector_t_iterator_next(vector_t_iterator *iter)
 {
-  if (iter->cursor >= iter->vector->size)
+  if (!vector_t_iterator_has_next(iter))
     return NULL;
 
+  if (iter->reverse)
+    return vector_t_get(iter->vector, --iter->cursor);
+
   return vector_t_get(iter->vector, iter->cursor++);
 }
 
 void vector_t_iterator_reset(vector_t_iterator *iter)
 {
-  iter->cursor = 0;
+  iter->cursor = iter->reverse ? iter->end : iter->begin;
+}
+
+void vector_t_for_each_prefetch(vector_t *v, vector_t_visit visit, void *context, const size_t distance)
+{
+  if (v == NULL || v->items == NULL)
+    return;
+
+  vector_t_flat(v);
+
+  if (v->width > 0)
+  {
+    // `visit` gets the members themselves, it may write them
+    if (vector_t_shared(v) && vector_t_unshare(v) != 0)
+      return;
+
+    char *item = (char *)v->items;
+
+    for (size_t i = 0; i < v->size; i++, item += v->width)
+      visit(item, i, context);
+
+    return;
+  }
+
+  void **items = v->items;
+  size_t length = v->length;
+
+  if (distance == 0)
+  {
+    for (size_t i = 0; i < length; i++)
+      if (items[i] != NULL)
+        visit(items[i], i, context);
+
+    return;
+  }
+
+  for (size_t i = 0; i < length; i++)
+  {
+    // prefetching NULL does not fault
+    if (i + distance < length)
+      __builtin_prefetch(items[i + distance]);
+
+    if (items[i] != NULL)
+      visit(items[i], i, context);
+  }
+}
+
+void vector_t_for_each(vector_t *v, vector_t_visit visit, void *context)
+{
+  vector_t_for_each_prefetch(v, visit, context, 0);
 }
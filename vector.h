@@ -12,6 +12,8 @@
 #ifndef VECTOR_H
 #define VECTOR_H
 
+#include "heap.h"
+
 /**
  * @brief generic vector container
  *
@@ -21,17 +23,204 @@ typedef struct vector_t vector_t;
 /**
  * @brief iterator for `vector_t`
  *
+ * Exposed so it can live on the stack, see `vector_t_iterator_init`.
+ * Members are private, use the `vector_t_iterator_*` functions.
+ */
+typedef struct vector_t_iterator
+{
+  vector_t *vector;
+  size_t cursor;
+  size_t begin;
+  size_t end;
+  int reverse;
+} vector_t_iterator;
+
+/**
+ * @brief reads the members of a snapshot written by `vector_t_save` or `matrix_t_save` in chunks
+ */
+typedef struct vector_t_reader vector_t_reader;
+
+/**
+ * @brief callback for `vector_t_for_each`
+ *
+ * @param[in] item member as returned by `vector_t_get`
+ * @param[in] index position of the member
+ * @param[in] context pointer given to `vector_t_for_each`
+ */
+typedef void (*vector_t_visit)(void *item, const size_t index, void *context);
+
+/**
+ * @brief tells whether a member matches, for `vector_t_remove_if` and `vector_t_retain`
+ *
+ * @param[in] item member as returned by `vector_t_get`
+ * @param[in] context pointer given to the caller
+ * @return non-zero when `item` matches
+ */
+typedef int (*vector_t_predicate)(const void *item, void *context);
+
+/**
+ * @brief compares two members of `vector_t`, as `qsort`, returning <0, 0 or >0
+ *
+ * Receives members as returned by `vector_t_get`: the pointers themselves for pointer vectors,
+ * addresses of the members for sized vectors.
  */
-typedef struct vector_t_iterator vector_t_iterator;
+typedef int (*vector_t_compare)(const void *a, const void *b);
+
+/**
+ * @brief counters of the `vector_t` hot paths over all vectors, kept when built with `-DVECTOR_STATS` (`make stats`)
+ *
+ * Growing as often as pushing or moving many bytes per insert point at quadratic usage patterns.
+ */
+typedef struct vector_t_stats_t
+{
+  size_t resizes; // `vector_t_resize` calls
+  size_t grows;   // reallocations of the buffer to a larger capacity
+  size_t moved;   // bytes shifted by inserts and removes, gap moves included
+  size_t pushes;  // `vector_t_push` calls, each is `O(1)` and scans nothing
+  size_t scanned; // slots visited by compacting, filtering, `vector_t_first_free` and trimming `length` after removes
+} vector_t_stats_t;
 
 /**
  * @brief creates a new `vector_t`
  *
+ * The first 8 pointers (64 bytes of a sized vector) are kept inside `vector_t` itself,
+ * `items` is only allocated once the vector grows past them.
+ *
  * @param[in] size initial vector capacity
  * @return `vector_t*` pointer for created vector
  */
 vector_t *vector_t_create(const size_t size);
 
+/**
+ * @brief creates a new `vector_t` storing members by value
+ *
+ * Members of `width` bytes are kept contiguously in the vector buffer instead of being pointers.
+ * `vector_t_set`, `vector_t_insert` and `vector_t_push` copy `width` bytes from the given pointer
+ * (or zero the member when `NULL`), and `vector_t_get` returns the address of the member inside the buffer.
+ *
+ * Sized vectors have no empty positions: `vector_t_insert` always shifts, `vector_t_remove` shrinks the size
+ * and `vector_t_length` is always equal to `vector_t_size`.
+ *
+ * @warning addresses returned by `vector_t_get` are invalidated when the vector grows
+ *
+ * @param[in] width size of each member in bytes, `0` creates a pointer vector as `vector_t_create`
+ * @param[in] size initial vector size, members are zeroed
+ * @return `vector_t*` pointer for created vector, `NULL` when its members can not be allocated
+ */
+vector_t *vector_t_create_sized(const size_t width, const size_t size);
+
+/**
+ * @brief creates a new `vector_t` whose memory comes from `allocator`
+ *
+ * The vector itself, its heap buffer and bitmap are taken from and given back to `allocator`,
+ * copies use the same one. Aligned and huge page buffers are still allocated as set by
+ * `vector_t_align` and `vector_t_huge_pages`.
+ *
+ * @param[in] size initial vector capacity
+ * @param[in] allocator must outlive the vector, `&heap_allocator` behaves as `vector_t_create`
+ * @return `vector_t*` pointer for created vector
+ */
+vector_t *vector_t_create_with_allocator(const size_t size, const allocator_t *allocator);
+
+/**
+ * @brief creates a new `vector_t` storing members by value whose memory comes from `allocator`
+ *
+ * @see vector_t_create_sized
+ * @see vector_t_create_with_allocator
+ *
+ * @param[in] width size of each member in bytes
+ * @param[in] size initial vector size, members are zeroed
+ * @param[in] allocator must outlive the vector
+ * @return `vector_t*` pointer for created vector
+ */
+vector_t *vector_t_create_sized_with_allocator(const size_t width, const size_t size, const allocator_t *allocator);
+
+/**
+ * @brief opens a sized `vector_t` kept in the file at `path`, creating it when missing
+ *
+ * Members live in a shared mapping of the file, so opening an existing vector takes no parsing
+ * and processes mapping the same file share the page cache. Growing extends the file and remaps it.
+ * `vector_t_destroy` writes the size back, unmaps and closes the file.
+ *
+ * @warning the file is not locked, only one process should modify it at a time
+ *
+ * @param[in] path
+ * @param[in] width size of each member in bytes, must match the one the file was created with
+ * @return `vector_t*` pointer for opened vector, `NULL` when the file can not be mapped or holds
+ * something else than a vector of `width` members
+ */
+vector_t *vector_t_open_mmap(const char *path, const size_t width);
+
+/**
+ * @brief flushes a vector opened by `vector_t_open_mmap` to its file
+ *
+ * @param[in] vector
+ * @return `0` on success, `-1` on failure or when the vector is not file backed
+ */
+int vector_t_sync(vector_t *vector);
+
+/**
+ * @brief writes the members of a sized `vector_t` to a binary snapshot at `path`
+ *
+ * The snapshot is a versioned header followed by the members as they are in memory,
+ * sent with a single vectored write. Readers only accept snapshots of the same byte order.
+ *
+ * @param[in] vector
+ * @param[in] path replaced once the snapshot is completely written
+ * @return `0` on success, `-1` on failure or for pointer vectors
+ */
+int vector_t_save(vector_t *vector, const char *path);
+
+/**
+ * @brief creates a sized `vector_t` out of the snapshot at `path`
+ *
+ * Members are read at once into a buffer already sized for all of them.
+ * Snapshots of `matrix_t_save` load as the flat vector of their members.
+ *
+ * @param[in] path
+ * @return `vector_t*` pointer for loaded vector, `NULL` when the file is not a valid snapshot
+ */
+vector_t *vector_t_load(const char *path);
+
+/**
+ * @brief opens the snapshot at `path` for reading members in chunks
+ *
+ * @param[in] path
+ * @return `vector_t_reader*`, `NULL` when the file is not a valid snapshot
+ */
+vector_t_reader *vector_t_reader_open(const char *path);
+
+/**
+ * @brief retrieves the size in bytes of each member of the snapshot
+ *
+ * @param[in] reader
+ */
+size_t vector_t_reader_width(const vector_t_reader *reader);
+
+/**
+ * @brief retrieves the total number of members of the snapshot
+ *
+ * @param[in] reader
+ */
+size_t vector_t_reader_count(const vector_t_reader *reader);
+
+/**
+ * @brief copies the next members of the snapshot into `buffer`
+ *
+ * @param[in] reader
+ * @param[out] buffer room for `count` members of `vector_t_reader_width` bytes
+ * @param[in] count maximum members to read
+ * @return number of members read, `0` at the end of the snapshot or on failure
+ */
+size_t vector_t_reader_read(vector_t_reader *reader, void *buffer, size_t count);
+
+/**
+ * @brief closes and frees `vector_t_reader`
+ *
+ * @param[in] reader
+ */
+void vector_t_reader_close(vector_t_reader *reader);
+
 /**
  * @brief initializes a `vector_t` pointer with 0-capacity
  *
@@ -47,22 +236,64 @@ void vector_t_init(vector_t **vector);
 void vector_t_destroy(vector_t *vector);
 
 /**
- * @brief retrieves the size (capacity) of `vector_t`
+ * @brief retrieves the size (addressable positions) of `vector_t`
  *
  * @param[in] vector
  */
 size_t vector_t_size(const vector_t *vector);
 
+/**
+ * @brief retrieves the length of `vector_t`
+ *
+ * Position right after the last non-null member, where `vector_t_push` places the next one.
+ *
+ * @note `O(1)`
+ *
+ * @param[in] vector
+ */
+size_t vector_t_length(const vector_t *vector);
+
+/**
+ * @brief retrieves the allocated capacity of `vector_t`
+ *
+ * @param[in] vector
+ */
+size_t vector_t_capacity(const vector_t *vector);
+
+/**
+ * @brief retrieves the member width of a sized `vector_t` or `0` for pointer vectors
+ *
+ * @param[in] vector
+ */
+size_t vector_t_element_size(const vector_t *vector);
+
 /**
  * @brief grows or shrinks a `vector_t`
  *
- * @warning trims the vector, removing any member after `size`, garbage-collects.
+ * @warning trims the vector, removing any member after `size`.
+ * @note allocated capacity is kept when shrinking, see `vector_t_shrink_to_fit`.
  *
  * @param[in] vector
  * @param[in] size
  */
 void vector_t_resize(vector_t *vector, const size_t size);
 
+/**
+ * @brief allocates room for at least `capacity` positions without changing the size
+ *
+ * @param[in] vector
+ * @param[in] capacity
+ * @return `0` on success, `-1` when the buffer can not grow, the vector is left unchanged
+ */
+int vector_t_reserve(vector_t *vector, const size_t capacity);
+
+/**
+ * @brief releases any allocated capacity beyond the size of `vector_t`
+ *
+ * @param[in] vector
+ */
+void vector_t_shrink_to_fit(vector_t *vector);
+
 /**
  * @brief moves all non-null members to the beginning of vector
  *
@@ -124,14 +355,52 @@ void vector_t_remove(vector_t *vector, size_t index, const size_t count);
 /**
  * @brief inserts member right after the last non-null position of `vector_t`
  *
- * @note uses `vector_t_resize` if needed.
- * @warning for big all
+ * @note amortized `O(1)`, capacity grows geometrically.
  *
  * @param[in] vector
  * @param[in] element
  */
 void vector_t_push(vector_t *vector, void *element);
 
+/**
+ * @brief inserts `count` members right after the last non-null position of `vector_t`
+ *
+ * `items` holds `count` members laid out as in the vector: pointers for pointer vectors,
+ * `width` bytes each for sized vectors.
+ *
+ * @note resizes at most once, `O(count)` amortized.
+ *
+ * @param[in] vector
+ * @param[in] items
+ * @param[in] count
+ */
+void vector_t_push_n(vector_t *vector, void *items, const size_t count);
+
+/**
+ * @brief inserts `count` members at given `index` in the `vector_t`
+ *
+ * Moves right all subsequent members up to the last non-null position by `count`,
+ * `items` is laid out as in `vector_t_push_n`.
+ *
+ * @note resizes at most once and moves the tail once.
+ *
+ * @param[in] vector
+ * @param[in] index
+ * @param[in] items
+ * @param[in] count
+ */
+void vector_t_insert_range(vector_t *vector, const size_t index, void *items, const size_t count);
+
+/**
+ * @brief appends all members of `other` up to its last non-null position
+ *
+ * @warning both vectors must hold the same kind of members, does nothing otherwise
+ *
+ * @param[in] vector
+ * @param[in] other
+ */
+void vector_t_append_vector(vector_t *vector, vector_t *other);
+
 /**
  * @brief move a member to a new index
  *
@@ -153,14 +422,46 @@ void vector_t_move(vector_t *vector, const size_t origin, const size_t destinati
  */
 void vector_t_swap(vector_t *vector, const size_t idx1, const size_t idx2);
 
+/**
+ * @brief removes all members matching `predicate`, keeping the order of the others
+ *
+ * Same result as calling `vector_t_remove` on each match, in a single pass.
+ * `NULL` positions of pointer vectors are not passed to `predicate` and stay in place.
+ *
+ * @note `O(n)`, capacity is kept, see `vector_t_shrink_to_fit`
+ *
+ * @param[in] vector
+ * @param[in] predicate
+ * @param[in] context passed to `predicate`
+ * @return number of members removed
+ */
+size_t vector_t_remove_if(vector_t *vector, vector_t_predicate predicate, void *context);
+
+/**
+ * @brief removes all members not matching `predicate`, keeping the order of the others
+ *
+ * @note `O(n)`, see `vector_t_remove_if`
+ *
+ * @param[in] vector
+ * @param[in] predicate
+ * @param[in] context passed to `predicate`
+ * @return number of members removed
+ */
+size_t vector_t_retain(vector_t *vector, vector_t_predicate predicate, void *context);
+
 /**
  * @brief copy the provided `vector_t`
  *
+ * `O(1)`: both vectors share the buffer until one of them is modified, which then copies it.
+ * Vectors of up to 8 members and file backed vectors are copied right away.
+ *
  * @warning members keep the same pointer as original vector
+ * @warning addresses returned by `vector_t_get` on sized vectors point into the shared buffer,
+ * write through them only after modifying the vector by its functions
  *
  * @param[in] vector
  */
-vector_t *vector_t_copy(const vector_t *vector);
+vector_t *vector_t_copy(vector_t *vector);
 
 /**
  * @brief reverse the provided `vector_t`
@@ -178,6 +479,125 @@ void vector_t_reverse(vector_t *vector);
  */
 void vector_t_clean(vector_t *vector);
 
+/**
+ * @brief enables or disables the occupancy bitmap of a pointer `vector_t`
+ *
+ * Keeps one bit per position alongside the members, set when the position holds a non-null member.
+ * `vector_t_count`, `vector_t_first_free`, `vector_t_compact` and finding the last non-null member
+ * then scan 64 positions per word instead of one pointer at a time.
+ *
+ * @note costs one bit per position of capacity, does nothing on sized or gap buffer vectors.
+ *
+ * @param[in] vector
+ * @param[in] enabled
+ */
+void vector_t_bitmap(vector_t *vector, const int enabled);
+
+/**
+ * @brief aligns the buffer of `vector_t` to `alignment` bytes, now and after growing
+ *
+ * Use `64` for cache line or AVX-512 aligned members. Members are moved when the current
+ * buffer is not aligned yet.
+ *
+ * @note does nothing on file backed vectors, see `vector_t_open_mmap`
+ *
+ * @param[in] vector
+ * @param[in] alignment power of two, `0` for the default of `malloc`
+ * @return `0` on success, `-1` when the buffer can not be moved, the alignment is left unchanged
+ */
+int vector_t_align(vector_t *vector, const size_t alignment);
+
+/**
+ * @brief enables or disables huge page backed buffers of `vector_t`
+ *
+ * Buffers of at least `HEAP_HUGE_THRESHOLD` bytes are mapped and advised for transparent huge pages,
+ * saving TLB misses on large vectors. They grow with `mremap`, moving pages instead of copying members.
+ * Smaller buffers stay on the heap.
+ *
+ * @note does nothing on file backed vectors, see `vector_t_open_mmap`
+ *
+ * @param[in] vector
+ * @param[in] enabled
+ * @return `0` on success, `-1` when the buffer can not be moved, the setting is left unchanged
+ */
+int vector_t_huge_pages(vector_t *vector, const int enabled);
+
+/**
+ * @brief reads the hot path counters of all vectors and threads
+ *
+ * @param[out] stats all zeroes when built without `VECTOR_STATS`
+ */
+void vector_t_stats(vector_t_stats_t *stats);
+
+/**
+ * @brief enables or disables gap buffer mode of `vector_t`
+ *
+ * Keeps a gap of unused positions that follows the edit position: `vector_t_insert` and
+ * `vector_t_remove` move the gap there and only shift the members in between, so edits around
+ * a cursor cost `O(distance moved)` instead of `O(n)`. `vector_t_get`, `vector_t_set` and
+ * `vector_t_size`, `vector_t_count` and `vector_t_first_free` work as usual; other functions, including
+ * copying, saving and appending from the vector, first move the gap back to the end.
+ *
+ * @note disables the occupancy bitmap, see `vector_t_bitmap`.
+ *
+ * @param[in] vector
+ * @param[in] enabled
+ */
+void vector_t_gap_buffer(vector_t *vector, const int enabled);
+
+/**
+ * @brief counts the non-null members of `vector_t`
+ *
+ * @param[in] vector
+ * @return number of non-null members
+ */
+size_t vector_t_count(const vector_t *vector);
+
+/**
+ * @brief retrieves the first position holding `NULL`
+ *
+ * @param[in] vector
+ * @return index of the first free position, `vector_t_length` when there is none before it
+ */
+size_t vector_t_first_free(const vector_t *vector);
+
+/**
+ * @brief sorts the members of `vector_t`
+ *
+ * Stable merge sort. All `NULL` values are moved to the end first, as in `vector_t_compact`.
+ * Large vectors are sorted in chunks by one thread per online CPU, then merged.
+ *
+ * @param[in] vector
+ * @param[in] compare
+ */
+void vector_t_sort(vector_t *vector, vector_t_compare compare);
+
+/**
+ * @brief finds the first position whose member is not less than `key`
+ *
+ * @warning the vector must be sorted with the same `compare`
+ * @note `O(log n)`
+ *
+ * @param[in] vector
+ * @param[in] key given as a member, see `vector_t_compare`
+ * @param[in] compare
+ * @return index of the position, `vector_t_length` when all members are less than `key`
+ */
+size_t vector_t_lower_bound(const vector_t *vector, const void *key, vector_t_compare compare);
+
+/**
+ * @brief finds a member equal to `key` in a sorted `vector_t`
+ *
+ * @warning the vector must be sorted with the same `compare`
+ * @note `O(log n)`
+ *
+ * @param[in] vector
+ * @param[in] key given as a member, see `vector_t_compare`
+ * @param[in] compare
+ * @return the member or `NULL`
+ */
+void *vector_t_bsearch(const vector_t *vector, const void *key, vector_t_compare compare);
+
 /**
  * @brief iterator for vector_t
  *
@@ -188,6 +608,52 @@ void vector_t_clean(vector_t *vector);
  */
 vector_t_iterator *vector_t_iterator_create(vector_t *vector);
 
+/**
+ * @brief initializes an iterator in place over all positions of vector_t
+ *
+ * Does not allocate, `vector_t_iterator_destroy` must not be called on it.
+ *
+ * ```c
+ * vector_t_iterator iter;
+ * vector_t_iterator_init(&iter, vector);
+ *
+ * while (vector_t_iterator_has_next(&iter))
+ *   item = vector_t_iterator_next(&iter);
+ * ```
+ *
+ * @param[out] iter
+ * @param[in] vector
+ */
+void vector_t_iterator_init(vector_t_iterator *iter, vector_t *vector);
+
+/**
+ * @brief initializes an iterator in place over positions `[from, to)` of vector_t
+ *
+ * @param[out] iter
+ * @param[in] vector
+ * @param[in] from first position, inclusive
+ * @param[in] to last position, exclusive
+ */
+void vector_t_iterator_init_range(vector_t_iterator *iter, vector_t *vector, const size_t from, const size_t to);
+
+/**
+ * @brief initializes an iterator in place going from the last position of vector_t to the first
+ *
+ * @param[out] iter
+ * @param[in] vector
+ */
+void vector_t_iterator_init_reverse(vector_t_iterator *iter, vector_t *vector);
+
+/**
+ * @brief checks whether there are positions left to visit
+ *
+ * Unlike a `NULL` returned by `vector_t_iterator_next`, tells empty positions apart from the end.
+ *
+ * @param[in] iter
+ * @return 1 when `vector_t_iterator_next` has a position to return
+ */
+int vector_t_iterator_has_next(const vector_t_iterator *iter);
+
 /**
  * @brief get the item at current position of vector_t or NULL
  *
@@ -214,8 +680,36 @@ void vector_t_iterator_reset(vector_t_iterator *iter);
 /**
  * @brief destroys the iterator and frees its memory
  *
+ * @warning only for iterators from `vector_t_iterator_create`
+ *
  * @param[in] iter the iterator to be destroyed
  */
 void vector_t_iterator_destroy(vector_t_iterator *iter);
 
+/**
+ * @brief calls `visit` for each member of vector_t, in order
+ *
+ * Walks the buffer directly, skipping `NULL` positions of pointer vectors.
+ *
+ * @warning `visit` must not resize the vector
+ *
+ * @param[in] vector
+ * @param[in] visit
+ * @param[in] context passed to each `visit` call
+ */
+void vector_t_for_each(vector_t *vector, vector_t_visit visit, void *context);
+
+/**
+ * @brief `vector_t_for_each` prefetching the members `distance` positions ahead
+ *
+ * For pointer vectors, prefetches the memory members point to, worth it when `visit`
+ * reads them and they are scattered in the heap.
+ *
+ * @param[in] vector
+ * @param[in] visit
+ * @param[in] context passed to each `visit` call
+ * @param[in] distance how many positions ahead to prefetch, `0` disables
+ */
+void vector_t_for_each_prefetch(vector_t *vector, vector_t_visit visit, void *context, const size_t distance);
+
 #endif
@@ -0,0 +1,143 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file vector_io.c
+ * @brief Binary snapshot files of `vector_t` and `matrix_t` members
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include "heap.h"
+#include "vector_io.h"
+
+/**
+ * @brief writes all of `iov`, resuming after partial writes
+ */
+static int vector_io_writev(const int fd, struct iovec *iov, int count)
+{
+  while (count > 0)
+  {
+    ssize_t written = writev(fd, iov, count);
+
+    if (written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      return -1;
+    }
+
+    for (; count > 0 && (size_t)written >= iov->iov_len; iov++, count--)
+      written -= iov->iov_len;
+
+    if (count > 0)
+    {
+      iov->iov_base = (char *)iov->iov_base + written;
+      iov->iov_len -= written;
+    }
+  }
+
+  return 0;
+}
+
+int vector_io_save(const char *path, vector_io_header *header, const void *data, size_t stored)
+{
+  size_t length = strlen(path);
+  char *tmp = malloc_realloc(length + 5, NULL);
+
+  if (tmp == NULL)
+    return -1;
+
+  if (stored > header->count)
+    stored = header->count;
+
+  memcpy(tmp, path, length);
+  memcpy(&tmp[length], ".tmp", 5);
+
+  memcpy(header->magic, VECTOR_IO_MAGIC, sizeof(header->magic));
+  header->version = VECTOR_IO_VERSION;
+  header->order = VECTOR_IO_ORDER;
+
+  struct iovec iov[2] = {
+      {header, sizeof(*header)},
+      {(void *)data, stored * header->width},
+  };
+
+  int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  int result = -1;
+
+  if (fd >= 0)
+  {
+    result = vector_io_writev(fd, iov, iov[1].iov_len > 0 ? 2 : 1);
+
+    if (result == 0 && stored < header->count)
+      result = ftruncate(fd, sizeof(*header) + header->count * header->width);
+
+    if (close(fd) != 0)
+      result = -1;
+
+    if (result == 0)
+      result = rename(tmp, path);
+
+    if (result != 0)
+      unlink(tmp);
+  }
+
+  heap_free(tmp);
+
+  return result;
+}
+
+int vector_io_read(const int fd, void *data, const size_t bytes)
+{
+  size_t done = 0;
+
+  while (done < bytes)
+  {
+    ssize_t r = read(fd, (char *)data + done, bytes - done);
+
+    if (r < 0 && errno == EINTR)
+      continue;
+
+    if (r <= 0)
+      return -1;
+
+    done += r;
+  }
+
+  return 0;
+}
+
+int vector_io_open(const char *path, vector_io_header *header)
+{
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+
+  if (fd < 0)
+    return -1;
+
+  // members are read into a buffer sized by the header, it must not claim more than the file holds
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(*header) || vector_io_read(fd, header, sizeof(*header)) != 0 ||
+      memcmp(header->magic, VECTOR_IO_MAGIC, sizeof(header->magic)) != 0 ||
+      header->version != VECTOR_IO_VERSION || header->order != VECTOR_IO_ORDER || header->width == 0 ||
+      header->count > ((size_t)st.st_size - sizeof(*header)) / header->width ||
+      (header->rows > 0 && (header->cols == 0 || header->rows > SIZE_MAX / header->cols ||
+                            header->rows * header->cols != header->count)))
+  {
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file vector_io.h
+ * @brief Binary snapshot files of `vector_t` and `matrix_t` members
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * A snapshot is a `vector_io_header` followed by `count * width` bytes of members,
+ * in the byte order of the machine that wrote it.
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef VECTOR_IO_H
+#define VECTOR_IO_H
+
+#define VECTOR_IO_MAGIC "VECTORS"
+#define VECTOR_IO_VERSION 1
+
+/**
+ * @brief written as is, readers reject files of another byte order
+ */
+#define VECTOR_IO_ORDER 0x01020304
+
+typedef struct
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t order;
+  uint64_t width;
+  uint64_t count;
+  // `0` for vectors, shape of `count` members for matrices
+  uint64_t rows;
+  uint64_t cols;
+} vector_io_header;
+
+/**
+ * @brief writes `header` and `header->count` members of `data` to `path`
+ *
+ * Fills the magic, version and byte order of `header`. Both are sent with a single `writev`,
+ * the file is written next to `path` and renamed over it once complete. Members past `stored`
+ * are not read from `data`, the file is extended with zeros instead.
+ *
+ * @return `0` on success, `-1` on failure
+ */
+int vector_io_save(const char *path, vector_io_header *header, const void *data, size_t stored);
+
+/**
+ * @brief opens `path` and reads its header into `header`
+ *
+ * @return file descriptor positioned at the first member, `-1` when the file can not be read,
+ * is not a snapshot of this version and byte order or is shorter than its header claims
+ */
+int vector_io_open(const char *path, vector_io_header *header);
+
+/**
+ * @brief reads exactly `bytes` from `fd` into `data`
+ *
+ * @return `0` on success, `-1` on failure or early end of file
+ */
+int vector_io_read(const int fd, void *data, const size_t bytes);
+
+#endif // VECTOR_IO_H
@@ -0,0 +1,325 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file vector_simd.c
+ * @brief SIMD scans over pointer arrays with runtime dispatch
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stdint.h>
+#include <pthread.h>
+#include "vector_simd.h"
+
+#if defined(__GNUC__) && defined(__x86_64__) && !defined(VECTOR_NO_SIMD)
+#define VECTOR_SIMD_X86
+#include <immintrin.h>
+#endif
+
+typedef size_t (*vector_simd_compact_fn)(void **, const size_t);
+typedef size_t (*vector_simd_scan_fn)(void *const *, const size_t);
+
+static size_t compact_scalar(void **items, const size_t length)
+{
+  size_t cursor = 0;
+
+  for (size_t i = 0; i < length; i++)
+    if (items[i] != NULL)
+      items[cursor++] = items[i];
+
+  return cursor;
+}
+
+static size_t count_scalar(void *const *items, const size_t length)
+{
+  size_t count = 0;
+
+  for (size_t i = 0; i < length; i++)
+    if (items[i] != NULL)
+      count++;
+
+  return count;
+}
+
+static size_t first_null_scalar(void *const *items, const size_t length)
+{
+  for (size_t i = 0; i < length; i++)
+    if (items[i] == NULL)
+      return i;
+
+  return length;
+}
+
+static size_t last_scalar(void *const *items, size_t length)
+{
+  while (length > 0 && items[length - 1] == NULL)
+    length--;
+
+  return length;
+}
+
+#ifdef VECTOR_SIMD_X86
+
+/**
+ * @brief 32-bit lane permutations packing the kept 64-bit lanes of a 4-bit mask to the front
+ */
+static const int32_t compact_avx2_lanes[16][8] = {
+    {0, 0, 0, 0, 0, 0, 0, 0},
+    {0, 1, 0, 0, 0, 0, 0, 0},
+    {2, 3, 0, 0, 0, 0, 0, 0},
+    {0, 1, 2, 3, 0, 0, 0, 0},
+    {4, 5, 0, 0, 0, 0, 0, 0},
+    {0, 1, 4, 5, 0, 0, 0, 0},
+    {2, 3, 4, 5, 0, 0, 0, 0},
+    {0, 1, 2, 3, 4, 5, 0, 0},
+    {6, 7, 0, 0, 0, 0, 0, 0},
+    {0, 1, 6, 7, 0, 0, 0, 0},
+    {2, 3, 6, 7, 0, 0, 0, 0},
+    {0, 1, 2, 3, 6, 7, 0, 0},
+    {4, 5, 6, 7, 0, 0, 0, 0},
+    {0, 1, 4, 5, 6, 7, 0, 0},
+    {2, 3, 4, 5, 6, 7, 0, 0},
+    {0, 1, 2, 3, 4, 5, 6, 7},
+};
+
+/**
+ * @brief bit `k` is set when pointer `k` of the 4 loaded is non-null
+ */
+__attribute__((target("avx2"))) static inline int used_avx2(const __m256i block)
+{
+  __m256i nulls = _mm256_cmpeq_epi64(block, _mm256_setzero_si256());
+  return ~_mm256_movemask_pd(_mm256_castsi256_pd(nulls)) & 0xf;
+}
+
+__attribute__((target("avx2"))) static size_t compact_avx2(void **items, const size_t length)
+{
+  size_t cursor = 0;
+  size_t i = 0;
+
+  // `cursor <= i`, so the 4 lanes stored never go past the block already loaded
+  for (; i + 4 <= length; i += 4)
+  {
+    __m256i block = _mm256_loadu_si256((const __m256i *)&items[i]);
+    int used = used_avx2(block);
+
+    if (used == 0)
+      continue;
+
+    if (used != 0xf || cursor != i)
+    {
+      __m256i lanes = _mm256_loadu_si256((const __m256i *)compact_avx2_lanes[used]);
+      _mm256_storeu_si256((__m256i *)&items[cursor], _mm256_permutevar8x32_epi32(block, lanes));
+    }
+
+    cursor += __builtin_popcount(used);
+  }
+
+  for (; i < length; i++)
+    if (items[i] != NULL)
+      items[cursor++] = items[i];
+
+  return cursor;
+}
+
+__attribute__((target("avx2"))) static size_t count_avx2(void *const *items, const size_t length)
+{
+  size_t count = 0;
+  size_t i = 0;
+
+  for (; i + 8 <= length; i += 8)
+  {
+    int used = used_avx2(_mm256_loadu_si256((const __m256i *)&items[i])) |
+               used_avx2(_mm256_loadu_si256((const __m256i *)&items[i + 4])) << 4;
+    count += __builtin_popcount(used);
+  }
+
+  return count + count_scalar(&items[i], length - i);
+}
+
+__attribute__((target("avx2"))) static size_t first_null_avx2(void *const *items, const size_t length)
+{
+  size_t i = 0;
+
+  for (; i + 8 <= length; i += 8)
+  {
+    int used = used_avx2(_mm256_loadu_si256((const __m256i *)&items[i])) |
+               used_avx2(_mm256_loadu_si256((const __m256i *)&items[i + 4])) << 4;
+
+    if (used != 0xff)
+      return i + __builtin_ctz(~used);
+  }
+
+  return i + first_null_scalar(&items[i], length - i);
+}
+
+__attribute__((target("avx2"))) static size_t last_avx2(void *const *items, size_t length)
+{
+  for (; length >= 8; length -= 8)
+  {
+    int used = used_avx2(_mm256_loadu_si256((const __m256i *)&items[length - 8])) |
+               used_avx2(_mm256_loadu_si256((const __m256i *)&items[length - 4])) << 4;
+
+    if (used != 0)
+      return length - 8 + (32 - __builtin_clz(used));
+  }
+
+  return last_scalar(items, length);
+}
+
+/**
+ * @brief bit `k` is set when pointer `k` of the 2 loaded is non-null
+ */
+__attribute__((target("sse4.1"))) static inline int used_sse4(const __m128i block)
+{
+  __m128i nulls = _mm_cmpeq_epi64(block, _mm_setzero_si128());
+  return ~_mm_movemask_pd(_mm_castsi128_pd(nulls)) & 0x3;
+}
+
+__attribute__((target("sse4.1"))) static size_t compact_sse4(void **items, const size_t length)
+{
+  size_t cursor = 0;
+  size_t i = 0;
+
+  for (; i + 2 <= length; i += 2)
+  {
+    __m128i block = _mm_loadu_si128((const __m128i *)&items[i]);
+    int used = used_sse4(block);
+
+    if (used == 0x3)
+    {
+      if (cursor != i)
+        _mm_storeu_si128((__m128i *)&items[cursor], block);
+
+      cursor += 2;
+    }
+    else if (used != 0)
+    {
+      items[cursor++] = items[i + (used >> 1)];
+    }
+  }
+
+  for (; i < length; i++)
+    if (items[i] != NULL)
+      items[cursor++] = items[i];
+
+  return cursor;
+}
+
+__attribute__((target("sse4.1"))) static size_t count_sse4(void *const *items, const size_t length)
+{
+  size_t count = 0;
+  size_t i = 0;
+
+  for (; i + 4 <= length; i += 4)
+  {
+    int used = used_sse4(_mm_loadu_si128((const __m128i *)&items[i])) |
+               used_sse4(_mm_loadu_si128((const __m128i *)&items[i + 2])) << 2;
+    count += __builtin_popcount(used);
+  }
+
+  return count + count_scalar(&items[i], length - i);
+}
+
+__attribute__((target("sse4.1"))) static size_t first_null_sse4(void *const *items, const size_t length)
+{
+  size_t i = 0;
+
+  for (; i + 4 <= length; i += 4)
+  {
+    int used = used_sse4(_mm_loadu_si128((const __m128i *)&items[i])) |
+               used_sse4(_mm_loadu_si128((const __m128i *)&items[i + 2])) << 2;
+
+    if (used != 0xf)
+      return i + __builtin_ctz(~used);
+  }
+
+  return i + first_null_scalar(&items[i], length - i);
+}
+
+__attribute__((target("sse4.1"))) static size_t last_sse4(void *const *items, size_t length)
+{
+  for (; length >= 4; length -= 4)
+  {
+    int used = used_sse4(_mm_loadu_si128((const __m128i *)&items[length - 4])) |
+               used_sse4(_mm_loadu_si128((const __m128i *)&items[length - 2])) << 2;
+
+    if (used != 0)
+      return length - 4 + (32 - __builtin_clz(used));
+  }
+
+  return last_scalar(items, length);
+}
+
+#endif
+
+static vector_simd_compact_fn compact_impl = NULL;
+static vector_simd_scan_fn count_impl = NULL;
+static vector_simd_scan_fn first_null_impl = NULL;
+static vector_simd_scan_fn last_impl = NULL;
+static pthread_once_t vector_simd_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief resolves implementations for the running CPU, once
+ */
+static void vector_simd_dispatch(void)
+{
+  vector_simd_compact_fn compact = compact_scalar;
+  vector_simd_scan_fn count = count_scalar;
+  vector_simd_scan_fn first_null = first_null_scalar;
+  vector_simd_scan_fn last = last_scalar;
+
+#ifdef VECTOR_SIMD_X86
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx2"))
+  {
+    compact = compact_avx2;
+    count = count_avx2;
+    first_null = first_null_avx2;
+    last = last_avx2;
+  }
+  else if (__builtin_cpu_supports("sse4.1"))
+  {
+    compact = compact_sse4;
+    count = count_sse4;
+    first_null = first_null_sse4;
+    last = last_sse4;
+  }
+#endif
+
+  compact_impl = compact;
+  count_impl = count;
+  first_null_impl = first_null;
+  last_impl = last;
+}
+
+static inline void vector_simd_init(void)
+{
+  pthread_once(&vector_simd_once, vector_simd_dispatch);
+}
+
+size_t vector_simd_compact(void **items, const size_t length)
+{
+  vector_simd_init();
+  return compact_impl(items, length);
+}
+
+size_t vector_simd_count(void *const *items, const size_t length)
+{
+  vector_simd_init();
+  return count_impl(items, length);
+}
+
+size_t vector_simd_first_null(void *const *items, const size_t length)
+{
+  vector_simd_init();
+  return first_null_impl(items, length);
+}
+
+size_t vector_simd_last(void *const *items, const size_t length)
+{
+  vector_simd_init();
+  return last_impl(items, length);
+}
@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file vector_simd.h
+ * @brief SIMD scans over pointer arrays used by `vector_t`
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * Each function picks at runtime the widest implementation supported by the CPU
+ * (AVX2, SSE4.1 or scalar). Build with `-DVECTOR_NO_SIMD` to always use the scalar one.
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stddef.h>
+
+#ifndef VECTOR_SIMD_H
+#define VECTOR_SIMD_H
+
+/**
+ * @brief moves all non-null pointers in `[0, length)` to the front, keeping their order
+ *
+ * @warning positions after the returned count hold garbage, callers set them to `NULL`
+ *
+ * @param[in] items
+ * @param[in] length
+ * @return number of non-null pointers
+ */
+size_t vector_simd_compact(void **items, const size_t length);
+
+/**
+ * @brief counts non-null pointers in `[0, length)`
+ *
+ * @param[in] items
+ * @param[in] length
+ * @return number of non-null pointers
+ */
+size_t vector_simd_count(void *const *items, const size_t length);
+
+/**
+ * @brief finds the first `NULL` in `[0, length)`
+ *
+ * @param[in] items
+ * @param[in] length
+ * @return index of the first `NULL`, `length` if there is none
+ */
+size_t vector_simd_first_null(void *const *items, const size_t length);
+
+/**
+ * @brief finds the last non-null pointer in `[0, length)`
+ *
+ * @param[in] items
+ * @param[in] length
+ * @return index right after the last non-null pointer, `0` if there is none
+ */
+size_t vector_simd_last(void *const *items, const size_t length);
+
+#endif // VECTOR_SIMD_H
@@ -0,0 +1,204 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file vector_sort.c
+ * @brief Sequential and parallel merge sort of pointer arrays
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "heap.h"
+#include "vector_sort.h"
+
+#define VECTOR_SORT_INSERTION 16
+#define VECTOR_SORT_PARALLEL 65536
+#define VECTOR_SORT_THREADS 16
+
+typedef struct
+{
+  void **items;
+  void **scratch;
+  size_t count;
+  vector_sort_compare compare;
+} vector_sort_chunk;
+
+static void insertion_sort(void **items, const size_t count, vector_sort_compare compare)
+{
+  for (size_t i = 1; i < count; i++)
+  {
+    void *item = items[i];
+    size_t j = i;
+
+    for (; j > 0 && compare(items[j - 1], item) > 0; j--)
+      items[j] = items[j - 1];
+
+    items[j] = item;
+  }
+}
+
+/**
+ * @brief merges sorted `[0, middle)` and `[middle, count)` of `items` through `scratch`
+ */
+static void merge(void **items, void **scratch, const size_t middle, const size_t count, vector_sort_compare compare)
+{
+  // already in order, common on partially sorted input
+  if (compare(items[middle - 1], items[middle]) <= 0)
+    return;
+
+  memcpy(scratch, items, middle * sizeof(void *));
+
+  size_t i = 0, j = middle, k = 0;
+
+  while (i < middle && j < count)
+    items[k++] = compare(items[j], scratch[i]) < 0 ? items[j++] : scratch[i++];
+
+  // remaining right members are already in place
+  memcpy(&items[k], &scratch[i], (middle - i) * sizeof(void *));
+}
+
+static void merge_sort(void **items, void **scratch, const size_t count, vector_sort_compare compare)
+{
+  if (count <= VECTOR_SORT_INSERTION)
+  {
+    insertion_sort(items, count, compare);
+    return;
+  }
+
+  size_t middle = count / 2;
+
+  merge_sort(items, scratch, middle, compare);
+  merge_sort(&items[middle], scratch, count - middle, compare);
+  merge(items, scratch, middle, count, compare);
+}
+
+static void *merge_sort_thread(void *arg)
+{
+  vector_sort_chunk *chunk = arg;
+  merge_sort(chunk->items, chunk->scratch, chunk->count, chunk->compare);
+  return NULL;
+}
+
+static void *merge_thread(void *arg)
+{
+  vector_sort_chunk *chunk = arg;
+  size_t middle = chunk[0].count;
+
+  merge(chunk[0].items, chunk[0].scratch, middle, middle + chunk[1].count, chunk[0].compare);
+  return NULL;
+}
+
+/**
+ * @brief number of threads to sort `count` pointers with
+ */
+static size_t sort_threads(const size_t count)
+{
+  if (count < VECTOR_SORT_PARALLEL)
+    return 1;
+
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  size_t threads = cpus > 1 ? (size_t)cpus : 1;
+
+  if (threads > VECTOR_SORT_THREADS)
+    threads = VECTOR_SORT_THREADS;
+
+  while (threads > 1 && count / threads < VECTOR_SORT_PARALLEL / 4)
+    threads--;
+
+  return threads;
+}
+
+int vector_sort_pointers(void **items, const size_t count, vector_sort_compare compare)
+{
+  if (count < 2)
+    return 0;
+
+  size_t threads = sort_threads(count);
+
+  if (threads == 1 && count <= VECTOR_SORT_INSERTION)
+  {
+    insertion_sort(items, count, compare);
+    return 0;
+  }
+
+  // a sequential merge never needs more than the left half, parallel runs each own their range
+  void **scratch = malloc_realloc(sizeof(void *) * (threads == 1 ? count / 2 + 1 : count), NULL);
+
+  if (scratch == NULL)
+    return -1;
+
+  if (threads == 1)
+  {
+    merge_sort(items, scratch, count, compare);
+    heap_free(scratch);
+    return 0;
+  }
+
+  vector_sort_chunk chunks[VECTOR_SORT_THREADS];
+  pthread_t ids[VECTOR_SORT_THREADS];
+  int started[VECTOR_SORT_THREADS];
+  size_t offset = 0;
+
+  for (size_t t = 0; t < threads; t++)
+  {
+    size_t size = count / threads + (t < count % threads ? 1 : 0);
+
+    chunks[t].items = &items[offset];
+    chunks[t].scratch = &scratch[offset];
+    chunks[t].count = size;
+    chunks[t].compare = compare;
+    offset += size;
+  }
+
+  // sorts in the calling thread when a thread can not be created
+  for (size_t t = 0; t < threads; t++)
+  {
+    started[t] = pthread_create(&ids[t], NULL, merge_sort_thread, &chunks[t]) == 0;
+
+    if (!started[t])
+      merge_sort_thread(&chunks[t]);
+  }
+
+  for (size_t t = 0; t < threads; t++)
+    if (started[t])
+      pthread_join(ids[t], NULL);
+
+  // merge neighbouring chunks pairwise, one thread per pair, until a single run is left
+  while (threads > 1)
+  {
+    size_t pairs = threads / 2;
+
+    for (size_t p = 0; p < pairs; p++)
+    {
+      started[p] = pthread_create(&ids[p], NULL, merge_thread, &chunks[2 * p]) == 0;
+
+      if (!started[p])
+        merge_thread(&chunks[2 * p]);
+    }
+
+    // pairs after `p` only read chunks after `2 * p`, safe to overwrite `p`
+    for (size_t p = 0; p < pairs; p++)
+    {
+      if (started[p])
+        pthread_join(ids[p], NULL);
+
+      chunks[p].items = chunks[2 * p].items;
+      chunks[p].scratch = chunks[2 * p].scratch;
+      chunks[p].count = chunks[2 * p].count + chunks[2 * p + 1].count;
+    }
+
+    if (threads % 2 == 1)
+      chunks[pairs] = chunks[threads - 1];
+
+    threads = pairs + threads % 2;
+  }
+
+  heap_free(scratch);
+
+  return 0;
+}
@@ -0,0 +1,35 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file vector_sort.h
+ * @brief Sorting of pointer arrays used by `vector_t`
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#include <stddef.h>
+
+#ifndef VECTOR_SORT_H
+#define VECTOR_SORT_H
+
+/**
+ * @brief compares two members, as `qsort`, returning <0, 0 or >0
+ */
+typedef int (*vector_sort_compare)(const void *a, const void *b);
+
+/**
+ * @brief stable merge sort of `count` non-null pointers, comparing the pointers themselves
+ *
+ * Arrays of at least `VECTOR_SORT_PARALLEL` pointers are split across one thread per online CPU,
+ * each sorting a chunk before the chunks are merged.
+ *
+ * @param[in] items
+ * @param[in] count
+ * @param[in] compare
+ * @return `0` on success, `-1` when the scratch buffer could not be allocated
+ */
+int vector_sort_pointers(void **items, const size_t count, vector_sort_compare compare);
+
+#endif // VECTOR_SORT_H
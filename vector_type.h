@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: MIT
+/**
+ * @file vector_type.h
+ * @brief Type specialized vectors generated at compile time
+ * @version 0.1
+ * @date 2023-05-02
+ *
+ * `VECTOR_DEFINE(name, T)` emits a `name_t` vector storing `T` members by value and a set of
+ * `static inline` functions named `name_<operation>`, following the sized `vector_t` semantics:
+ * there are no empty positions, insert always shifts and remove shrinks the size.
+ *
+ * Being fully typed and inlined, loops over these vectors can be optimized by the compiler
+ * where calls to `vector_t` can not.
+ *
+ * @warning `name_get` does not check bounds, use `name_size`.
+ *
+ * ```c
+ * VECTOR_DEFINE(int_vector, int)
+ *
+ * int_vector_t *v = int_vector_create(0);
+ * int_vector_push(v, 42);
+ * int_vector_get(v, 0) == 42;
+ * int_vector_destroy(v);
+ * ```
+ *
+ * @copyright Copyright (c) 2023 lightningspirit
+ *
+ */
+
+#ifndef VECTOR_TYPE_H
+#define VECTOR_TYPE_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "heap.h"
+
+/**
+ * @brief defines `name_t` vector of `T` and its functions
+ *
+ * @param name prefix for the type and functions
+ * @param T member type
+ */
+#define VECTOR_DEFINE(name, T)                                                         \
+  typedef struct name##_t                                                              \
+  {                                                                                    \
+    size_t size;                                                                       \
+    size_t capacity;                                                                   \
+    T *items;                                                                          \
+  } name##_t;                                                                          \
+                                                                                       \
+  static inline int name##_reserve(name##_t *v, const size_t capacity)                 \
+  {                                                                                    \
+    if (capacity <= v->capacity)                                                       \
+      return 0;                                                                        \
+                                                                                       \
+    if (capacity > SIZE_MAX / sizeof(T))                                               \
+      return -1;                                                                       \
+                                                                                       \
+    T *items = (T *)malloc_realloc(sizeof(T) * capacity, v->items);                    \
+                                                                                       \
+    if (items == NULL)                                                                 \
+      return -1;                                                                       \
+                                                                                       \
+    v->items = items;                                                                  \
+    v->capacity = capacity;                                                            \
+    return 0;                                                                          \
+  }                                                                                    \
+                                                                                       \
+  static inline int name##_grow(name##_t *v, const size_t size)                        \
+  {                                                                                    \
+    if (size <= v->capacity)                                                           \
+      return 0;                                                                        \
+                                                                                       \
+    size_t capacity = v->capacity > 0 ? v->capacity : 4;                               \
+                                                                                       \
+    while (capacity < size)                                                            \
+      capacity = capacity <= SIZE_MAX / 2 ? capacity * 2 : size;                       \
+                                                                                       \
+    return name##_reserve(v, capacity);                                                \
+  }                                                                                    \
+                                                                                       \
+  static inline int name##_resize(name##_t *v, const size_t size)                      \
+  {                                                                                    \
+    if (size > v->size)                                                                \
+    {                                                                                  \
+      if (name##_reserve(v, size) != 0)                                                \
+        return -1;                                                                     \
+                                                                                       \
+      memset(&v->items[v->size], 0, (size - v->size) * sizeof(T));                     \
+    }                                                                                  \
+                                                                                       \
+    v->size = size;                                                                    \
+    return 0;                                                                          \
+  }                                                                                    \
+                                                                                       \
+  static inline name##_t *name##_create(const size_t size)                             \
+  {                                                                                    \
+    name##_t *v = (name##_t *)malloc_realloc(sizeof(name##_t), NULL);                  \
+                                                                                       \
+    if (v == NULL)                                                                     \
+      return NULL;                                                                     \
+                                                                                       \
+    v->size = 0;                                                                       \
+    v->capacity = 0;                                                                   \
+    v->items = NULL;                                                                   \
+                                                                                       \
+    if (size > 0 && name##_resize(v, size) != 0)                                       \
+    {                                                                                  \
+      heap_free(v);                                                                    \
+      return NULL;                                                                     \
+    }                                                                                  \
+                                                                                       \
+    return v;                                                                          \
+  }                                                                                    \
+                                                                                       \
+  static inline void name##_destroy(name##_t *v)                                       \
+  {                                                                                    \
+    if (v == NULL)                                                                     \
+      return;                                                                          \
+                                                                                       \
+    heap_free(v->items);                                                               \
+    heap_free(v);                                                                      \
+  }                                                                                    \
+                                                                                       \
+  static inline size_t name##_size(const name##_t *v)                                  \
+  {                                                                                    \
+    return v->size;                                                                    \
+  }                                                                                    \
+                                                                                       \
+  static inline T *name##_data(const name##_t *v)                                      \
+  {                                                                                    \
+    return v->items;                                                                   \
+  }                                                                                    \
+                                                                                       \
+  static inline T name##_get(const name##_t *v, const size_t index)                    \
+  {                                                                                    \
+    return v->items[index];                                                            \
+  }                                                                                    \
+                                                                                       \
+  static inline void name##_set(name##_t *v, const size_t index, T item)               \
+  {                                                                                    \
+    if (index >= v->size)                                                              \
+    {                                                                                  \
+      if (name##_grow(v, index + 1) != 0)                                              \
+        return;                                                                        \
+                                                                                       \
+      name##_resize(v, index + 1);                                                     \
+    }                                                                                  \
+                                                                                       \
+    v->items[index] = item;                                                            \
+  }                                                                                    \
+                                                                                       \
+  static inline void name##_push(name##_t *v, T item)                                  \
+  {                                                                                    \
+    if (v->size == v->capacity && name##_grow(v, v->size + 1) != 0)                    \
+      return;                                                                          \
+                                                                                       \
+    v->items[v->size++] = item;                                                        \
+  }                                                                                    \
+                                                                                       \
+  static inline void name##_insert(name##_t *v, const size_t index, T item)            \
+  {                                                                                    \
+    if (index > v->size)                                                               \
+    {                                                                                  \
+      name##_set(v, index, item);                                                      \
+      return;                                                                          \
+    }                                                                                  \
+                                                                                       \
+    if (v->size == v->capacity && name##_grow(v, v->size + 1) != 0)                    \
+      return;                                                                          \
+                                                                                       \
+    if (index < v->size)                                                               \
+      memmove(&v->items[index + 1], &v->items[index], (v->size - index) * sizeof(T));  \
+                                                                                       \
+    v->items[index] = item;                                                            \
+    v->size++;                                                                         \
+  }                                                                                    \
+                                                                                       \
+  static inline void name##_remove(name##_t *v, const size_t index, size_t count)      \
+  {                                                                                    \
+    if (index >= v->size)                                                              \
+      return;                                                                          \
+                                                                                       \
+    if (count > v->size - index)                                                       \
+      count = v->size - index;                                                         \
+                                                                                       \
+    memmove(&v->items[index], &v->items[index + count],                                \
+            (v->size - index - count) * sizeof(T));                                    \
+    v->size -= count;                                                                  \
+  }                                                                                    \
+                                                                                       \
+  static inline void name##_for_each(const name##_t *v, void (*fn)(const T *, void *), \
+                                     void *ctx)                                        \
+  {                                                                                    \
+    for (size_t i = 0; i < v->size; i++)                                               \
+      fn(&v->items[i], ctx);                                                           \
+  }
+
+#endif // VECTOR_TYPE_H